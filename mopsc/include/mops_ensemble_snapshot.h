@@ -0,0 +1,152 @@
+ /*!
+  * @file   mops_ensemble_snapshot.h
+  * @brief  Columnar binary snapshots of the particle ensemble
+  *
+  *   About:
+  *      A save point stores the whole reactor through the polymorphic
+  *      serialisation chain, which must be read back into a full object
+  *      graph before any statistics can be taken.  An ensemble snapshot
+  *      stores only what post-processing needs: the PSL table of the
+  *      ensemble, one column per PSL variable, and optionally the primary
+  *      and connectivity tables of the aggregates.  Snapshots are read by
+  *      mapping the file into memory, so that the columns are used in
+  *      place.
+  *
+  *   Licence:
+  *      mops is free software; you can redistribute it and/or
+  *      modify it under the terms of the GNU Lesser General Public License
+  *      as published by the Free Software Foundation; either version 2
+  *      of the License, or (at your option) any later version.
+  *
+  *      This program is distributed in the hope that it will be useful,
+  *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *      GNU Lesser General Public License for more details.
+  *
+  *      You should have received a copy of the GNU Lesser General Public
+  *      License along with this program; if not, write to the Free Software
+  *      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+  *      02111-1307, USA.
+  *
+  *   Contact:
+  *      Prof Markus Kraft
+  *      Dept of Chemical Engineering
+  *      University of Cambridge
+  *      New Museums Site
+  *      Pembroke Street
+  *      Cambridge
+  *      CB2 3RA, UK
+  *
+  *      Email:       mk306@cam.ac.uk
+  *      Website:     http://como.cheng.cam.ac.uk
+  */
+#ifndef MOPS_ENSEMBLE_SNAPSHOT_H_
+#define MOPS_ENSEMBLE_SNAPSHOT_H_
+
+#include "mops_params.h"
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace Mops {
+
+// Forward declaration.
+class Reactor;
+
+/*!
+ * @brief   Memory-mapped columnar snapshot of a particle ensemble.
+ *
+ * The file starts with a fixed header (magic, version, step, run, flags,
+ * row and column counts, time and sample volume), followed by the PSL
+ * table stored column by column.  Column 0 holds the raw statistical
+ * weight of each particle, so that the number density can be scaled by
+ * the number of runs when the snapshot is read.  If the primary flag is
+ * set, the connectivity (node) and primary tables of EnsembleStats::
+ * PrintPrimary follow, each as a list of row offsets and the row entries.
+ *
+ * All fields are 8-byte aligned, and the file is written in the byte
+ * order of the machine, like the save points.
+ */
+class EnsembleSnapshot {
+public:
+    //! Version of the file format
+    static const unsigned int Version = 0;
+
+    //! Write a snapshot of the reactor ensemble
+    static void Write(
+        const std::string &fname,
+        const Reactor &r,
+        unsigned int step,
+        unsigned int run,
+        double time,
+        bool primaries);
+
+    //! Default constructor, no file is mapped
+    EnsembleSnapshot();
+
+    //! Destructor, unmaps the file
+    ~EnsembleSnapshot();
+
+    //! Map a snapshot file, returns false if the file cannot be opened
+    bool Open(const std::string &fname);
+
+    //! Unmap the file
+    void Close();
+
+    //! Is a file mapped?
+    bool IsOpen() const {return m_data != NULL;}
+
+    //! Step number of the snapshot
+    unsigned int Step() const;
+
+    //! Run number of the snapshot
+    unsigned int Run() const;
+
+    //! Time at which the PSL was taken (s)
+    double Time() const;
+
+    //! Sample volume of the ensemble (m3)
+    double SampleVolume() const;
+
+    //! Number of particles (rows of the PSL table)
+    unsigned int ParticleCount() const;
+
+    //! Number of PSL variables (columns of the PSL table)
+    unsigned int ColumnCount() const;
+
+    //! Column i of the PSL table, ParticleCount() entries
+    const double *Column(unsigned int i) const;
+
+    //! Get the PSL of particle j, with the weight scaled to cm-3
+    void PSL(unsigned int j, double scale, fvector &psl) const;
+
+    //! Does the snapshot hold the primary tables?
+    bool HasPrimaries() const;
+
+    //! Append the connectivity rows to a table
+    void GetNodes(std::vector<fvector> &nodes) const;
+
+    //! Append the primary rows to a table
+    void GetPrimaries(std::vector<fvector> &prims) const;
+
+private:
+    //! Snapshots are not copied
+    EnsembleSnapshot(const EnsembleSnapshot &copy);
+    EnsembleSnapshot &operator=(const EnsembleSnapshot &rhs);
+
+    //! Append the rows of a table starting at word pos
+    void getTable(std::size_t pos, std::vector<fvector> &rows) const;
+
+    //! Check that words [pos, pos+n) lie in the file
+    void checkRange(std::size_t pos, std::size_t n) const;
+
+    //! Mapped file
+    void *m_data;
+
+    //! Size of the mapped file in bytes
+    std::size_t m_size;
+};
+
+} // Mops namespace
+
+#endif /* MOPS_ENSEMBLE_SNAPSHOT_H_ */
@@ -111,6 +111,15 @@ public:
     //! Returns the current mechanism.
     const Mops::Mechanism *const Mech() const {return m_mech;}
 
+    //! Reads the inflow reactor's mixture through a copy, or directly
+    void SetBuffered(bool buffered);
+
+    //! Is the inflow reactor's mixture read through a copy?
+    bool IsBuffered() const {return m_buf != NULL;}
+
+    //! Copies the inflow reactor's mixture into the buffer
+    void UpdateBuffer();
+
 
     // READ/WRITE/COPY FUNCTIONS.
 
@@ -138,6 +147,12 @@ private:
     // or it may point to reactor conditions (specified inflow).
     Mops::Mixture *m_mix;
 
+    // Copy of the inflow reactor's mixture, which is read in place of
+    // it when the stream is buffered.  The copy is only refreshed by
+    // UpdateBuffer(), so the stream presents the reactor's state at the
+    // time of the last update while the reactor itself is being solved.
+    Mops::Mixture *m_buf;
+
     // Defining mechanism.
     const Mops::Mechanism *m_mech;
 
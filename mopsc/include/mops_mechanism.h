@@ -57,10 +57,14 @@ class Mechanism
 public:
     // Constructors.
     Mechanism(void); // Default constructor.
+    Mechanism(const Mechanism &copy); // Copy constructor.
 
     // Destructors.
     ~Mechanism(void); // Default destructors.
 
+    // Operators.
+    Mechanism &operator=(const Mechanism &rhs);
+
     // PARTICLE MECHANISM.
 
     // Returns a reference (non-const) to the particle mechanism.
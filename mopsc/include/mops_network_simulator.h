@@ -59,14 +59,32 @@ struct Node {
     //! A pointer to this node's solver
     Mops::Solver* sol;
 
-    Node(): reac(NULL), sim(NULL), sol(NULL) {}
+    //! This node's copy of the mechanism, if nodes are solved concurrently
+    Mops::Mechanism* mech;
+
+    //! The mechanism the reactor used before it was given the copy
+    const Mops::Mechanism* netmech;
+
+    Node(): reac(NULL), sim(NULL), sol(NULL), mech(NULL), netmech(NULL) {}
 
     Node(Mops::PSR& r, Mops::Simulator& s, Mops::Solver& sl):
-        reac(&r), sim(&s), sol(&sl) {}
+        reac(&r), sim(&s), sol(&sl), mech(NULL), netmech(NULL) {}
 };
 
 class NetworkSimulator {
 public:
+    //! How the nodes are solved within each time step
+    enum StepMode {
+        //! One after another in path order, sharing one random number stream
+        Serial_Steps,
+        //! All at once, each reading the state of its upstream nodes at the
+        //! start of the step
+        Concurrent_Steps,
+        //! In wavefronts of an acyclic network, each wavefront at once and
+        //! reading the state of its upstream nodes at the end of the step
+        Wavefront_Steps
+    };
+
     //! Constructor
     NetworkSimulator(
             const Mops::Simulator &sim,
@@ -89,7 +107,15 @@ public:
     //! Postprocess the binary outputs into CSVs
     void PostProcess();
 
+    //! Returns how the nodes are solved within each time step
+    StepMode GetStepMode() const {return mMode;}
+
+    //! Sets how the nodes are solved within each time step
+    void SetStepMode(StepMode mode) {mMode = mode;}
+
 private:
+    typedef std::vector<std::vector<unsigned int> > Wavefronts;
+
     typedef std::vector<Mops::Node> SimPath;
 
     typedef SimPath::iterator s_iter;
@@ -103,6 +129,26 @@ private:
     //! Creates a simulator for a PSR
     Mops::Simulator* CreateSimulator(const Mops::PSR* r);
 
+    //! Gives a node its own copy of the network's mechanism
+    void BindMechanism(Mops::Node &n, const Mops::ReactorNetwork &net);
+
+    //! Points a node's reactor back to the network's mechanism
+    void UnbindMechanism(Mops::Node &n);
+
+    //! Can the nodes be solved concurrently?
+    bool CanStepConcurrently();
+
+    //! Groups the nodes into the sets which are solved at once
+    Wavefronts FindWavefronts(StepMode mode);
+
+    //! Advances one node to the end of the step
+    void SolveNode(
+            Mops::Node &n,
+            double t2,
+            int nsplit,
+            unsigned int istep,
+            Sweep::rng_type &rng);
+
     //! Number of runs of the network
     unsigned int mRuns;
 
@@ -117,6 +163,9 @@ private:
 
     //! A list of (reactors, simulators) in the order they should be solved
     SimPath mSimulators;
+
+    //! How the nodes are solved within each time step
+    StepMode mMode;
 };
 
 }
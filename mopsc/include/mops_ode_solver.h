@@ -62,6 +62,9 @@
 
 namespace Mops
 {
+// Forward declaration.
+class SparseLinearSolver;
+
 class ODE_Solver
 {
 public:
@@ -83,6 +86,9 @@ public:
     // Enumeration of ODE solvers.
     // enum SolverType {CVODE_Solver, RADAU5_Solver};
 
+    // Enumeration of linear solvers for the Newton iteration.
+    enum LinearSolverType {Dense_Solver, Sparse_Solver};
+
     
     // SOLVER SETUP.
 
@@ -97,6 +103,13 @@ public:
     // contents has been changed between calls to Solve().
     void ResetSolver(Reactor &reac);
 
+    // Restarts the solver after the reactor contents have been changed
+    // between calls to Solve(), e.g. by a particle step.  If the change
+    // is within the restart tolerance the integration continues from the
+    // changed state with the current order, step size and Jacobian,
+    // otherwise the solver is reset as by ResetSolver().
+    void RestartSolver(void);
+
     // Sets the time in the ODE solver.
 //    void SetTime(double time);
 
@@ -127,6 +140,32 @@ public:
     void SetRTOL(double rtol);
 
 
+    // Returns the tolerance on the change of state for which
+    // RestartSolver() continues the integration, as an RMS norm
+    // weighted by the error tolerances.
+    double RestartTolerance() const;
+
+    // Sets the restart tolerance.  A tolerance of zero (the default)
+    // makes RestartSolver() always reset the solver.
+    void SetRestartTolerance(double tol);
+
+
+    // LINEAR SOLVER.
+
+    // Returns the linear solver used for the Newton iteration.
+    LinearSolverType LinearSolver() const;
+
+    // Sets the linear solver used for the Newton iteration.  The sparse
+    // solver is only used for reactors which have an analytic Jacobian,
+    // and never for sensitivity problems; the dense solver is used
+    // otherwise.
+    void SetLinearSolver(LinearSolverType type);
+
+    // Returns the sparse linear solver in use, or NULL if the dense
+    // solver is in use.  This gives the factorisation statistics.
+    const SparseLinearSolver *SparseSolver() const;
+
+
     // EXTERNAL SOURCE TERMS.
 
     // Returns the vector of external source terms.
@@ -195,6 +234,8 @@ private:
 protected:
     // ODE solution variables.
     double m_rtol, m_atol;    // Relative and absolute tolerances.
+    double m_restart_tol;     // Tolerance for warm restarts.
+    LinearSolverType m_linsolver; // Linear solver for the Newton iteration.
     unsigned int m_neq;     // Number of equations solved.
 //    unsigned int m_nsp;     // Number of species in current mechanism.
 //    int m_iT;               // Index of temperature in solution vectors.
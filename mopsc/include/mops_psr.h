@@ -179,6 +179,9 @@ protected:
         double *ydot           // Derivatives to return.
         ) const;
 
+    //! The Jacobian omits the inflow and outflow terms
+    bool HasAnalyticJacobian() const;
+
 private:
 
     //! Initialise the birth process of the specific inflow
@@ -264,6 +264,28 @@ namespace Mops
 			double uround             // Perturbation size parameter.
 			) const;
 
+		// Returns true if Jacobian() is exact enough to be given to the
+		// ODE solver in place of its own difference quotients.  This is
+		// not the case if the RHS contains terms that Jacobian() omits.
+		virtual bool HasAnalyticJacobian() const;
+
+		// Returns the sparsity pattern (compressed columns) of the species
+		// block of the analytic Jacobian.
+		void JacobianSparsity(
+			std::vector<unsigned int> &start, // First entry of each column, plus end.
+			std::vector<unsigned int> &rows   // Row of each entry.
+			) const;
+
+		// Calculates the analytic Jacobian in the bordered sparse form
+		// used by the sparse linear solver.  The pattern must already be
+		// held in J, as returned by JacobianSparsity().
+		void SparseJacobian(
+			double t,                 // Flow time.
+			double *const y,          // Solution values.
+			Sprog::Kinetics::SparseJacobian &J, // Sparse Jacobian.
+			double uround             // Perturbation size parameter.
+			) const;
+
 		//! Calculates Jacobian domegai/dcj instead of d/dxj[dxi/dt], as is done above.
 		void RateJacobian(
 			double t,                 // Flow time.
@@ -318,6 +340,13 @@ namespace Mops
 		int m_iDens;            // Index of density in solution vectors.
 		double *m_deriv;          // Array to hold current solution derivatives.
 
+		// Workspace for the RHS functions, sized when the mechanism is set.
+		// Each reactor has its own so that reactors may be integrated
+		// concurrently; mutable as the RHS functions are const.
+		mutable fvector m_wdot; // Gas-phase molar production rates.
+		mutable fvector m_sdot; // Surface molar production rates.
+		mutable fvector m_Hs;   // Species enthalpies (or internal energies).
+
 		// Reactors should not be defined without knowledge of a Mechanism
 		// object.  Therefore the default constructor is declared as protected.
 		Reactor(void);
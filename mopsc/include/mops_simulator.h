@@ -100,6 +100,15 @@ public:
     // Sets the number of iterations to perform per step.
     void SetIterCount(unsigned int n);
 
+    // Returns the number of threads over which the runs are distributed.
+    unsigned int ThreadCount(void) const;
+
+    // Sets the number of threads over which the runs are distributed.  The
+    // runs are independent, so each thread performs whole runs on its own
+    // copies of the mechanism, reactor and solver.  Has no effect unless
+    // compiled with OpenMP.
+    void SetThreadCount(unsigned int n);
+
     // Sets the time vector.
     void SetTimeVector(const timevector &times);
 
@@ -252,6 +261,9 @@ private:
     // Number of internal solver iterations to perform.
     unsigned int m_niter;
 
+    // Number of threads over which runs are distributed.
+    unsigned int m_nthreads;
+
     // Simulation time vector.
     timevector m_times;
 
@@ -366,6 +378,44 @@ private:
     // that element.
     std::vector<std::string> m_flux_elements;
 
+    // RUNS.
+
+    // Performs a single run on the given reactor, starting from a copy
+    // of the initial mixture.  The output file must already be open.
+    void solveRun(
+        Reactor &r,                  // Reactor object to solve.
+        Solver &s,                   // Solver to use for simulation.
+        const Mixture &initmix,      // Initial reactor contents.
+        unsigned int irun,           // Run number.
+        size_t seed,                 // Seed from which the run seed is generated.
+        const std::string &basename, // Output file name for save points.
+        unsigned int &icon,          // Steps remaining until console output.
+        bool console                 // Set =false to suppress console rows.
+        );
+
+    // Returns true if the runs for the given reactor and solver may
+    // be distributed over threads.
+    bool canRunParallel(const Reactor &r, const Solver &s) const;
+
+    // Performs all runs, distributing them over m_nthreads threads.  The
+    // output of the runs is appended to the output file in run order.
+    // Note that the CPU times are measured with clock(), which counts
+    // the time of all threads in the process.
+    void runParallel(
+        const Reactor &r,           // Reactor defining the simulation.
+        const Solver &s,            // Solver to copy for each run.
+        const Mixture &initmix,     // Initial reactor contents.
+        size_t seed,                // Seed from which the run seeds are generated.
+        const std::string &basename // Output file name.
+        );
+
+    // Returns the base name of the part output files for the given run.
+    static std::string partFileName(const std::string &basename, unsigned int irun);
+
+    // Appends the contents of the given file to the output stream and
+    // deletes the file.
+    static void appendPartFile(const std::string &fname, std::fstream &out);
+
     // LOI THINGS
 
     //! Set up the LOI calculation
@@ -685,7 +735,8 @@ private:
     // SAVE POINTS AND PSL POST-PROCESSING.
 
     // Creates a simulation save point.  The save points can be
-    // used to restart an interrupted simulation.
+    // used to restart an interrupted simulation.  An ensemble
+    // snapshot (.csp) is written alongside for PSL post-processing.
     void createSavePoint(
         const Reactor &r,  // Reactor to output.
         unsigned int step, // Step number.
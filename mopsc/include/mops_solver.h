@@ -113,6 +113,20 @@ public:
     // calculations.
     void SetRTOL(double rtol);
 
+    // Returns the tolerance for warm restarts of the ODE solver
+    // between splitting steps.
+    double RestartTolerance() const;
+
+    // Sets the tolerance for warm restarts of the ODE solver.  Zero
+    // disables warm restarts.
+    void SetRestartTolerance(double tol);
+
+    // Returns the linear solver used by the ODE solver.
+    ODE_Solver::LinearSolverType LinearSolver() const;
+
+    // Sets the linear solver used by the ODE solver.
+    void SetLinearSolver(ODE_Solver::LinearSolverType type);
+
     // LOI STATUS FOR ODE SOLVER.
 
     //! Enables LOI status to true.
@@ -138,6 +152,19 @@ public:
     // Sets the under-relaxation coefficient.
     void SetUnderRelaxCoeff(double relax);
 
+    // SPLITTING STEP CONTROL.
+
+    // Returns the limit on the relative change of the gas phase over
+    // one operator-splitting step.
+    double GasChangeTolerance(void) const;
+
+    // Sets the limit on the gas-phase change per splitting step.  This
+    // is not an estimate of the operator-splitting error.  Splitting
+    // solvers choose their step size adaptively if the limit is
+    // positive, otherwise they take the number of steps given to
+    // Solve() (the default).
+    void SetGasChangeTolerance(double tol);
+
     // Calculates and stores various properties used to complete the 
     // energy balance so they can be computed less frequently. 
     void storeTemperatureProperties(
@@ -223,6 +250,12 @@ protected:
     // Default error tolerances for the ODE solver.
     double m_atol, m_rtol;
 
+    // Tolerance for warm restarts of the ODE solver.
+    double m_restart_tol;
+
+    // Linear solver for the ODE solver.
+    ODE_Solver::LinearSolverType m_linsolver;
+
     // SENSITIVITY SETTINGS
 
     //! Boolean variable for setting LOI status
@@ -234,6 +267,9 @@ protected:
     // Under-relaxation coefficient.
     double m_rlx_coeff;
 
+    // Limit on the gas-phase change per adaptive splitting step.
+    double m_gas_change_tol;
+
     // LOI KEPT SPECIES
 
     //! String vector containing the names of kept species
@@ -0,0 +1,177 @@
+ /*!
+  * @file   mops_sparse_linear_solver.h
+  * @brief  Sparse direct linear solver for CVODE
+  *
+  *   About:
+  *      CVODE linear solver module which solves the Newton systems of the
+  *      gas-phase ODE solver with the analytic sparse Jacobian of the
+  *      reaction set and a sparse LU factorisation.  The structure of the
+  *      factors is found once per mechanism and reused for every
+  *      factorisation.
+  *
+  *   Licence:
+  *      mops is free software; you can redistribute it and/or
+  *      modify it under the terms of the GNU Lesser General Public License
+  *      as published by the Free Software Foundation; either version 2
+  *      of the License, or (at your option) any later version.
+  *
+  *      This program is distributed in the hope that it will be useful,
+  *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *      GNU Lesser General Public License for more details.
+  *
+  *      You should have received a copy of the GNU Lesser General Public
+  *      License along with this program; if not, write to the Free Software
+  *      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+  *      02111-1307, USA.
+  *
+  *   Contact:
+  *      Prof Markus Kraft
+  *      Dept of Chemical Engineering
+  *      University of Cambridge
+  *      New Museums Site
+  *      Pembroke Street
+  *      Cambridge
+  *      CB2 3RA, UK
+  *
+  *      Email:       mk306@cam.ac.uk
+  *      Website:     http://como.cheng.cam.ac.uk
+  */
+#ifndef MOPS_SPARSE_LINEAR_SOLVER_H_
+#define MOPS_SPARSE_LINEAR_SOLVER_H_
+
+#include "mops_params.h"
+#include "mops_sparse_lu.h"
+#include "gpc_reaction_set.h"
+
+// CVODE includes.
+#include "nvector/nvector_serial.h"
+#include "cvodes_impl.h" // For CVodeMem.
+
+#include <vector>
+
+namespace Mops {
+
+// Forward declaration.
+class Mechanism;
+
+/*!
+ * @brief   Sparse direct solver for the Newton systems of CVODE.
+ *
+ * The mole fraction equations couple every species through the term
+ * x_i * wtot / rho, so the species block of the Jacobian is the sparse
+ * reaction block less the outer product u v^T.  Rather than factorise the
+ * dense sum, the Newton matrix I - gamma*J is bordered by the unknown
+ * z = v^T dx, giving a system of NSP+3 unknowns whose species block keeps
+ * the sparsity of the mechanism.  The border (z, temperature and density)
+ * is eliminated last.
+ *
+ * The module is attached in place of CVDense, and its memory is held by
+ * CVODE as the linear solver memory.  Jacobian updates follow the same
+ * rules as CVDense.
+ */
+class SparseLinearSolver {
+public:
+    //! Attach the sparse solver to a CVODE workspace
+    static void Attach(void *cvode_mem);
+
+    //! Is the sparse solver attached to the CVODE workspace?
+    static bool IsAttached(const void *cvode_mem);
+
+    //! Returns the sparse solver attached to a workspace, or NULL
+    static const SparseLinearSolver *Find(const void *cvode_mem);
+
+    //! Copy the linear solver of one CVODE workspace to another
+    static void Copy(CVodeMemRec &mem_dsc, const CVodeMemRec &mem_src);
+
+    //! Number of Jacobian evaluations
+    long int JacobianCount() const {return m_nje;}
+
+    //! Number of numerical factorisations
+    long int FactorisationCount() const {return m_nfact;}
+
+    //! CPU time spent in numerical factorisations (s)
+    double FactorisationTime() const {return m_tfact;}
+
+    //! Number of factorisations that met a small pivot and were done densely
+    unsigned long DenseFactorisationCount() const {return m_lu.DenseCount();}
+
+    //! Number of entries in the Newton matrix
+    unsigned int PatternSize() const {return m_lu.PatternSize();}
+
+    //! Number of entries in the LU factors
+    unsigned int FactorSize() const {return m_lu.FactorSize();}
+
+private:
+    //! The workspace is only created by Attach()
+    SparseLinearSolver();
+
+    // CVODE LINEAR SOLVER INTERFACE.
+
+    //! Initialise the solver at the start of an integration
+    static int init(CVodeMemRec *cv_mem);
+
+    //! Evaluate the Jacobian if needed, and factorise the Newton matrix
+    static int setup(CVodeMemRec *cv_mem, int convfail,
+                     N_Vector ypred, N_Vector fpred, booleantype *jcurPtr,
+                     N_Vector vtemp1, N_Vector vtemp2, N_Vector vtemp3);
+
+    //! Solve the Newton system
+    static int solve(CVodeMemRec *cv_mem, N_Vector b, N_Vector weight,
+                     N_Vector ycur, N_Vector fcur);
+
+    //! Release the solver memory
+    static void release(CVodeMemRec *cv_mem);
+
+    // NEWTON MATRIX.
+
+    //! Build the pattern of the bordered Newton matrix
+    void analyse(const Mechanism *mech, const std::vector<unsigned int> &start,
+                 const std::vector<unsigned int> &rows);
+
+    //! Fill the bordered Newton matrix from the saved Jacobian
+    void assemble(double gamma);
+
+    //! Mechanism whose pattern has been analysed
+    const Mechanism *m_mech;
+
+    //! Number of species
+    unsigned int m_nsp;
+
+    //! Saved Jacobian
+    Sprog::Kinetics::SparseJacobian m_jac;
+
+    //! Start of each row of the Newton matrix, plus end
+    std::vector<unsigned int> m_start;
+
+    //! Column of each entry of the Newton matrix
+    std::vector<unsigned int> m_cols;
+
+    //! Entry of the Newton matrix for each entry of the species block
+    std::vector<unsigned int> m_spmap;
+
+    //! Entries of the Newton matrix
+    fvector m_values;
+
+    //! Factors of the Newton matrix
+    SparseLU m_lu;
+
+    //! Bordered right hand side
+    fvector m_rhs;
+
+    //! Step number of the last Jacobian evaluation
+    long int m_nstlj;
+
+    //! Number of Jacobian evaluations
+    long int m_nje;
+
+    //! Number of numerical factorisations
+    long int m_nfact;
+
+    //! CPU time spent in numerical factorisations
+    double m_tfact;
+};
+
+} // Mops namespace
+
+#endif /* MOPS_SPARSE_LINEAR_SOLVER_H_ */
@@ -0,0 +1,154 @@
+ /*!
+  * @file   mops_sparse_lu.h
+  * @brief  Declaration of a sparse LU factorisation for the ODE solver
+  *
+  *   About:
+  *      Sparse LU factorisation without pivoting, as used for the Newton
+  *      matrices of the gas-phase ODE solver.  The pattern is analysed once,
+  *      choosing a fill-reducing order and the fill-in of the factors, so
+  *      that each new matrix with the same pattern only costs the numerical
+  *      factorisation.
+  *
+  *   Licence:
+  *      mops is free software; you can redistribute it and/or
+  *      modify it under the terms of the GNU Lesser General Public License
+  *      as published by the Free Software Foundation; either version 2
+  *      of the License, or (at your option) any later version.
+  *
+  *      This program is distributed in the hope that it will be useful,
+  *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *      GNU Lesser General Public License for more details.
+  *
+  *      You should have received a copy of the GNU Lesser General Public
+  *      License along with this program; if not, write to the Free Software
+  *      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+  *      02111-1307, USA.
+  *
+  *   Contact:
+  *      Prof Markus Kraft
+  *      Dept of Chemical Engineering
+  *      University of Cambridge
+  *      New Museums Site
+  *      Pembroke Street
+  *      Cambridge
+  *      CB2 3RA, UK
+  *
+  *      Email:       mk306@cam.ac.uk
+  *      Website:     http://como.cheng.cam.ac.uk
+  */
+#ifndef MOPS_SPARSE_LU_H_
+#define MOPS_SPARSE_LU_H_
+
+#include "mops_params.h"
+#include <vector>
+
+namespace Mops {
+
+/*!
+ * @brief   Sparse LU factorisation with a static pattern.
+ *
+ * The matrix is given in compressed row form.  Analyse() orders the first
+ * n - nfixed unknowns by minimum degree on the symmetrised pattern and
+ * keeps the last nfixed unknowns in place, so that dense border rows and
+ * columns are eliminated last and cause no fill in the sparse block.  The
+ * sparse factorisation does not pivot, which suits the diagonally dominated
+ * Newton matrices I - gamma*J of stiff chemistry.  If a pivot is small
+ * compared with the rest of its row of U, the matrix is factorised densely
+ * with partial pivoting instead, and Solve() uses the dense factors.
+ */
+class SparseLU {
+public:
+    //! Default constructor
+    SparseLU();
+
+    //! Analyse the pattern and find the structure of the factors
+    void Analyse(
+            unsigned int n,
+            const std::vector<unsigned int> &start,
+            const std::vector<unsigned int> &cols,
+            unsigned int nfixed);
+
+    //! Factorise a matrix with the analysed pattern
+    bool Factorise(const fvector &values);
+
+    //! Solve in place using the last factorisation
+    void Solve(double *b) const;
+
+    //! Number of unknowns
+    unsigned int Size() const {return m_n;}
+
+    //! Number of entries in the matrix pattern
+    unsigned int PatternSize() const {return m_map.size();}
+
+    //! Number of entries in the factors, including fill-in
+    unsigned int FactorSize() const {return m_col.size();}
+
+    //! Number of factorisations that fell back on the dense factors
+    unsigned long DenseCount() const {return m_ndense;}
+
+    //! Smallest ratio of a sparse pivot to the largest entry of its row of U
+    static const double PivotTolerance;
+
+private:
+    //! Number of unknowns
+    unsigned int m_n;
+
+    //! Original index of each reordered unknown
+    std::vector<unsigned int> m_perm;
+
+    //! Reordered index of each original unknown
+    std::vector<unsigned int> m_iperm;
+
+    //! Start of each row of the factors, plus end
+    std::vector<unsigned int> m_start;
+
+    //! Column of each entry of the factors, sorted within rows
+    std::vector<unsigned int> m_col;
+
+    //! Position of the diagonal in each row
+    std::vector<unsigned int> m_diag;
+
+    //! Position in the factors of each entry of the analysed pattern
+    std::vector<unsigned int> m_map;
+
+    //! L (unit diagonal, below) and U (on and above the diagonal)
+    fvector m_lu;
+
+    //! Dense row used during factorisation and solution
+    mutable fvector m_work;
+
+    //! Start of each row of the analysed pattern, plus end
+    std::vector<unsigned int> m_pstart;
+
+    //! Column of each entry of the analysed pattern
+    std::vector<unsigned int> m_pcols;
+
+    //! True if the last factorisation is held in m_dense
+    bool m_use_dense;
+
+    //! Dense LU factors, stored by rows, used when a sparse pivot is small
+    fvector m_dense;
+
+    //! Row interchanged with each row of the dense factors
+    std::vector<unsigned int> m_pivots;
+
+    //! Number of factorisations that fell back on the dense factors
+    unsigned long m_ndense;
+
+    //! Factorise densely with partial pivoting
+    bool factoriseDense(const fvector &values);
+
+    //! Solve in place using the dense factors
+    void solveDense(double *b) const;
+
+    //! Choose the elimination order
+    void order(
+            const std::vector<unsigned int> &start,
+            const std::vector<unsigned int> &cols,
+            unsigned int nfixed);
+};
+
+} // Mops namespace
+
+#endif /* MOPS_SPARSE_LU_H_ */
@@ -70,6 +70,15 @@ public:
     ~StrangSolver(void); // Default destructor.
 
 
+    // SOLVER INITIALISATION AND RESET.
+
+    //! Initialises the solver and its splitting step control
+    virtual void Initialise(Reactor &r);
+
+    //! Resets the solver and its splitting step control
+    virtual void Reset(Reactor &r);
+
+
     // SOLUTION.
 
     // Solves the coupled reactor using a Strang splitting algorithm
@@ -85,7 +94,59 @@ public:
             void *data    // Custom data object which will be passed as argument to out().
         );
 
+
+    // COMPUTATION TIME.
+
+    // Returns the number of CT time variables tracked by this
+    // solver type.
+    unsigned int CT_Count(void) const;
+
+    // Outputs internal computation time data to the given
+    // binary stream.
+    void OutputCT(std::ostream &out) const;
+
+    // Adds the CT descriptions to a vector of strings.
+    void CT_Names(
+        std::vector<std::string> &names, // Vector to which to add names.
+        unsigned int start=0 // Optional start index in vector.
+        ) const;
+
 private:
+    // ADAPTIVE SPLITTING.
+
+    //! Splitting step proposed for the next adaptive step
+    double m_split_dt;
+
+    //! Number of accepted splitting steps
+    unsigned int m_nsplit_acc;
+
+    //! Number of rejected splitting steps
+    unsigned int m_nsplit_rej;
+
+    //! Gas-phase state at the start of the step, for rolling back
+    fvector m_y0;
+
+    //! Forget the step size and zero the step counts
+    void resetSplitting();
+
+    // Solves the reactor up to the stop time with adaptive
+    // splitting steps.
+    void adaptiveSolve(
+        Reactor &r,     // Reactor to solve.
+        double tstop,   // The end time for the step.
+        int nsteps,     // Number of steps for the first step size.
+        Sweep::rng_type &rng);
+
+    // Takes one symmetric splitting step, unless the gas-phase change
+    // measured after the first half-step of chemistry is too large.
+    // Returns false if the step was rolled back.
+    bool strangStep(
+        double dt,      // Splitting step size.
+        double hmin,    // Step size below which the step is always taken.
+        Reactor &r,     // Reactor to solve.
+        Sweep::rng_type &rng,
+        double &err);   // Gas-phase change scaled by its limit.
+
     // SIMULATION.
 
     // Performs n Strang splitting steps.
@@ -43,6 +43,8 @@
     Website:     http://como.cheng.cam.ac.uk
 */
 #include "cvodes_utils.h"
+#include "mops_sparse_linear_solver.h"
+#include "cvodes/cvodes_dense.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
@@ -698,9 +700,13 @@ void CVODES::CVodeMemRecCopy_Serial(CVodeMemRec &mem_dsc, CVodeMemRec &mem_src)
 
     //  /* Linear Solver specific memory */
     //  void *cv_lmem;
-        // Assuming a particular linear solver. 
-        // TODO:It will need to be looked at if other linear solver are used (they can be the same, it has not been investigated.).
-        if (mem_src.cv_lmem != NULL) {
+        // Either the sparse solver or CVDense is attached.  The solver of
+        // the destination is changed to match the source first.
+        if (SparseLinearSolver::IsAttached(&mem_src)) {
+            SparseLinearSolver::Copy(mem_dsc, mem_src);
+        } else if (mem_src.cv_lmem != NULL) {
+            if (SparseLinearSolver::IsAttached(&mem_dsc))
+                CVDense(&mem_dsc, ((CVDlsMem)mem_src.cv_lmem)->d_n);
             CVDlsMemRec &lmem_dsc  = *((CVDlsMem)mem_dsc.cv_lmem);
             CVDlsMemRec &lmem_src = *((CVDlsMem)mem_src.cv_lmem);
             CVDlsMemRecCopy_Serial(lmem_dsc, lmem_src);
@@ -0,0 +1,352 @@
+ /*!
+  * @file   mops_ensemble_snapshot.cpp
+  * @brief  Implementation of the columnar binary ensemble snapshots
+  *
+  *   Licence:
+  *      mops is free software; you can redistribute it and/or
+  *      modify it under the terms of the GNU Lesser General Public License
+  *      as published by the Free Software Foundation; either version 2
+  *      of the License, or (at your option) any later version.
+  *
+  *      This program is distributed in the hope that it will be useful,
+  *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *      GNU Lesser General Public License for more details.
+  *
+  *      You should have received a copy of the GNU Lesser General Public
+  *      License along with this program; if not, write to the Free Software
+  *      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+  *      02111-1307, USA.
+  *
+  *   Contact:
+  *      Prof Markus Kraft
+  *      Dept of Chemical Engineering
+  *      University of Cambridge
+  *      New Museums Site
+  *      Pembroke Street
+  *      Cambridge
+  *      CB2 3RA, UK
+  *
+  *      Email:       mk306@cam.ac.uk
+  *      Website:     http://como.cheng.cam.ac.uk
+  */
+#include "mops_ensemble_snapshot.h"
+#include "mops_reactor.h"
+#include "swp_ensemble_stats.h"
+
+#include <boost/cstdint.hpp>
+
+#include <fstream>
+#include <stdexcept>
+#include <cstring>
+
+// POSIX memory mapping.
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace Mops;
+
+namespace
+{
+    typedef boost::uint64_t word;
+
+    //! File identifier, padded to one word
+    const char magic[8] = {'M', 'O', 'P', 'S', 'C', 'S', 'P', '\0'};
+
+    //! Flag set if the primary tables are stored
+    const word primary_flag = 1;
+
+    //! Positions of the header fields, in words
+    enum HeaderField {
+        Magic_Word, Version_Word, Step_Word, Run_Word, Flags_Word,
+        Rows_Word, Cols_Word, Time_Word, Volume_Word, Header_Words
+    };
+
+    void writeWord(std::ostream &out, word w)
+    {
+        out.write(reinterpret_cast<const char*>(&w), sizeof(w));
+    }
+
+    void writeDouble(std::ostream &out, double x)
+    {
+        out.write(reinterpret_cast<const char*>(&x), sizeof(x));
+    }
+
+    //! Write a table as row offsets followed by the entries
+    void writeTable(std::ostream &out, const std::vector<fvector> &rows)
+    {
+        writeWord(out, rows.size());
+        word pos = 0;
+        writeWord(out, pos);
+        for (unsigned int i = 0; i != rows.size(); ++i) {
+            pos += rows[i].size();
+            writeWord(out, pos);
+        }
+        for (unsigned int i = 0; i != rows.size(); ++i) {
+            if (!rows[i].empty())
+                out.write(reinterpret_cast<const char*>(&rows[i][0]),
+                          rows[i].size() * sizeof(double));
+        }
+    }
+}
+
+// WRITING.
+
+/*!
+ * @param[in]   fname       Output file name (incl. extension)
+ * @param[in]   r           Reactor whose ensemble is written
+ * @param[in]   step        Step number
+ * @param[in]   run         Run number
+ * @param[in]   time        Time passed to the PSL calculation (s)
+ * @param[in]   primaries   Also write the primary and connectivity tables
+ *
+ * @exception   std::runtime_error  Failed to open the output file
+ */
+void EnsembleSnapshot::Write(const std::string &fname, const Reactor &r,
+                             unsigned int step, unsigned int run,
+                             double time, bool primaries)
+{
+    const Sweep::Mechanism &pmech = r.Mech()->ParticleMech();
+    const Sweep::Ensemble &ens = r.Mixture()->Particles();
+    const unsigned int n = r.Mixture()->ParticleCount();
+
+    Sweep::Stats::EnsembleStats stats(pmech);
+    const unsigned int ncols = stats.PSL_Count();
+
+    // Build the PSL table column by column.  The first column is the
+    // raw statistical weight rather than the scaled number density.
+    fvector table(ncols * n);
+    fvector psl;
+    std::vector<fvector> nodes, prims;
+    for (unsigned int j = 0; j != n; ++j) {
+        stats.PSL(*ens.At(j), pmech, time, psl, 1.0);
+        psl[0] = ens.At(j)->getStatisticalWeight();
+        for (unsigned int i = 0; i != ncols; ++i)
+            table[i * n + j] = psl[i];
+
+        if (primaries)
+            stats.PrintPrimary(*ens.At(j), pmech, nodes, prims, j);
+    }
+
+    std::ofstream fout;
+    fout.open(fname.c_str(), std::ios_base::out | std::ios_base::trunc |
+                             std::ios_base::binary);
+    if (!fout.good()) {
+        throw std::runtime_error("Failed to open file for ensemble snapshot "
+                                 "output (Mops, EnsembleSnapshot::Write).");
+    }
+
+    fout.write(magic, sizeof(magic));
+    writeWord(fout, Version);
+    writeWord(fout, step);
+    writeWord(fout, run);
+    writeWord(fout, primaries ? primary_flag : 0);
+    writeWord(fout, n);
+    writeWord(fout, ncols);
+    writeDouble(fout, time);
+    writeDouble(fout, r.Mixture()->SampleVolume());
+
+    if (!table.empty())
+        fout.write(reinterpret_cast<const char*>(&table[0]),
+                   table.size() * sizeof(double));
+
+    if (primaries) {
+        writeTable(fout, nodes);
+        writeTable(fout, prims);
+    }
+
+    fout.close();
+}
+
+// READING.
+
+//! Default constructor
+EnsembleSnapshot::EnsembleSnapshot()
+: m_data(NULL), m_size(0)
+{}
+
+//! Destructor
+EnsembleSnapshot::~EnsembleSnapshot()
+{
+    Close();
+}
+
+/*!
+ * The file is mapped read-only, and its header is checked.  The mapping
+ * stays valid until Close() is called or another file is opened.
+ *
+ * @param[in]   fname       Snapshot file name
+ *
+ * @return      False if the file does not exist or cannot be mapped
+ *
+ * @exception   std::runtime_error  The file is not a valid snapshot
+ */
+bool EnsembleSnapshot::Open(const std::string &fname)
+{
+    Close();
+
+    const int fd = open(fname.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if ((fstat(fd, &st) != 0) || (st.st_size == 0)) {
+        close(fd);
+        return false;
+    }
+
+    void *p = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) return false;
+
+    m_data = p;
+    m_size = st.st_size;
+
+    // Check the header.
+    if ((m_size < Header_Words * sizeof(word)) ||
+        (std::memcmp(m_data, magic, sizeof(magic)) != 0)) {
+        Close();
+        throw std::runtime_error("File is not an ensemble snapshot "
+                                 "(Mops, EnsembleSnapshot::Open).");
+    }
+    if (static_cast<const word*>(m_data)[Version_Word] != Version) {
+        Close();
+        throw std::runtime_error("Unsupported ensemble snapshot version "
+                                 "(Mops, EnsembleSnapshot::Open).");
+    }
+    checkRange(Header_Words, static_cast<std::size_t>(ColumnCount()) * ParticleCount());
+
+    return true;
+}
+
+//! Unmap the file
+void EnsembleSnapshot::Close()
+{
+    if (m_data != NULL) {
+        munmap(m_data, m_size);
+        m_data = NULL;
+        m_size = 0;
+    }
+}
+
+// HEADER.
+
+unsigned int EnsembleSnapshot::Step() const
+{
+    return static_cast<const word*>(m_data)[Step_Word];
+}
+
+unsigned int EnsembleSnapshot::Run() const
+{
+    return static_cast<const word*>(m_data)[Run_Word];
+}
+
+double EnsembleSnapshot::Time() const
+{
+    return static_cast<const double*>(m_data)[Time_Word];
+}
+
+double EnsembleSnapshot::SampleVolume() const
+{
+    return static_cast<const double*>(m_data)[Volume_Word];
+}
+
+unsigned int EnsembleSnapshot::ParticleCount() const
+{
+    return static_cast<const word*>(m_data)[Rows_Word];
+}
+
+unsigned int EnsembleSnapshot::ColumnCount() const
+{
+    return static_cast<const word*>(m_data)[Cols_Word];
+}
+
+bool EnsembleSnapshot::HasPrimaries() const
+{
+    return (static_cast<const word*>(m_data)[Flags_Word] & primary_flag) != 0;
+}
+
+// PSL TABLE.
+
+/*!
+ * @param[in]   i       Column index
+ *
+ * @return      Pointer into the mapped file
+ */
+const double *EnsembleSnapshot::Column(unsigned int i) const
+{
+    return static_cast<const double*>(m_data) + Header_Words +
+           static_cast<std::size_t>(i) * ParticleCount();
+}
+
+/*!
+ * @param[in]   j       Particle index
+ * @param[in]   scale   Scaling of the weight, as in EnsembleStats::PSL
+ * @param[out]  psl     PSL entry of the particle
+ */
+void EnsembleSnapshot::PSL(unsigned int j, double scale, fvector &psl) const
+{
+    const unsigned int ncols = ColumnCount();
+    psl.resize(ncols);
+    if (ncols == 0) return;
+
+    // m-3 to cm-3, as in EnsembleStats::PSL.
+    psl[0] = Column(0)[j] * scale * 1.0e-6;
+    for (unsigned int i = 1; i != ncols; ++i)
+        psl[i] = Column(i)[j];
+}
+
+// PRIMARY TABLES.
+
+void EnsembleSnapshot::GetNodes(std::vector<fvector> &nodes) const
+{
+    if (!HasPrimaries()) return;
+    getTable(Header_Words + static_cast<std::size_t>(ColumnCount()) * ParticleCount(),
+             nodes);
+}
+
+void EnsembleSnapshot::GetPrimaries(std::vector<fvector> &prims) const
+{
+    if (!HasPrimaries()) return;
+
+    // Skip the node table.
+    const std::size_t pos = Header_Words +
+        static_cast<std::size_t>(ColumnCount()) * ParticleCount();
+    checkRange(pos, 1);
+    const word *w = static_cast<const word*>(m_data);
+    const std::size_t nrows = w[pos];
+    checkRange(pos + 1, nrows + 1);
+    getTable(pos + nrows + 2 + w[pos + nrows + 1], prims);
+}
+
+/*!
+ * @param[in]   pos     Word at which the table starts
+ * @param[out]  rows    Rows of the table are appended here
+ */
+void EnsembleSnapshot::getTable(std::size_t pos, std::vector<fvector> &rows) const
+{
+    checkRange(pos, 1);
+    const word *w = static_cast<const word*>(m_data);
+    const std::size_t nrows = w[pos];
+    checkRange(pos + 1, nrows + 1);
+
+    const word *offset = w + pos + 1;
+    const std::size_t data = pos + nrows + 2;
+    checkRange(data, offset[nrows]);
+
+    const double *x = static_cast<const double*>(m_data) + data;
+    for (std::size_t i = 0; i != nrows; ++i)
+        rows.push_back(fvector(x + offset[i], x + offset[i + 1]));
+}
+
+/*!
+ * @exception   std::runtime_error  The words lie beyond the end of the file
+ */
+void EnsembleSnapshot::checkRange(std::size_t pos, std::size_t n) const
+{
+    if ((pos + n) * sizeof(word) > m_size) {
+        throw std::runtime_error("Ensemble snapshot is truncated "
+                                 "(Mops, EnsembleSnapshot::checkRange).");
+    }
+}
@@ -52,6 +52,7 @@ Mops::FlowStream::FlowStream(const Mops::Mechanism &mech)
 : m_in(NULL),
   m_out(NULL),
   m_mix(NULL),
+  m_buf(NULL),
   m_mech(&mech),
   m_flow_frac(1.0)
 {
@@ -64,6 +65,7 @@ Mops::FlowStream::FlowStream(const Mops::FlowStream &copy)
 : m_in(NULL),
   m_out(NULL),
   m_mix(NULL),
+  m_buf(NULL),
   m_mech(copy.m_mech),
   m_flow_frac(copy.m_flow_frac)
 {*this = copy;}
@@ -75,6 +77,7 @@ Mops::FlowStream::FlowStream(
 : m_in(NULL),
   m_out(NULL),
   m_mix(NULL),
+  m_buf(NULL),
   m_mech(&mech),
   m_flow_frac(1.0)
 {
@@ -85,6 +88,7 @@ Mops::FlowStream::FlowStream(
 Mops::FlowStream::~FlowStream()
 {
     if (!m_in) delete m_mix;
+    delete m_buf;
 }
 
 // OPERATORS.
@@ -95,10 +99,12 @@ Mops::FlowStream &Mops::FlowStream::operator=(const Mops::FlowStream &rhs)
     if (this != &rhs) {
         m_in = rhs.m_in;
         m_out = rhs.m_out;
+        delete m_buf;
+        m_buf = NULL;
         if (m_in) {
             // If stream inflow is defined then this flow-stream
-            // does not own the mixture.
-            m_mix = rhs.m_mix;
+            // does not own the mixture.  The buffer is not copied.
+            m_mix = rhs.m_buf ? m_in->Mixture() : rhs.m_mix;
         } else {
             // The flow stream does own the mixture, so create a copy.
             m_mix = rhs.m_mix->Clone();
@@ -136,6 +142,36 @@ void Mops::FlowStream::ConnectInflow(Mops::PSR &r)
     // Set the inflow and store pointer to inflow mixture.
     m_in  = &r;
     m_mix = r.Mixture();
+
+    // A buffered stream reads a copy of the new mixture.
+    if (m_buf) {
+        *m_buf = *m_mix;
+        m_mix  = m_buf;
+    }
+}
+
+// Buffering an inflow reactor's mixture lets the reactor be solved while
+// the reactor downstream of the stream reads its state, as the network
+// simulator does when nodes are solved concurrently.  Streams without an
+// inflow reactor own their mixture and are never buffered.
+void Mops::FlowStream::SetBuffered(bool buffered)
+{
+    if (buffered && m_in && !m_buf) {
+        m_buf = m_in->Mixture()->Clone();
+        m_mix = m_buf;
+    } else if (!buffered && m_buf) {
+        delete m_buf;
+        m_buf = NULL;
+        m_mix = m_in->Mixture();
+    }
+}
+
+// Copies the inflow reactor's mixture into the buffer.  The cells of the
+// processes which read the stream point at the buffer, so it is copied
+// into rather than replaced.
+void Mops::FlowStream::UpdateBuffer()
+{
+    if (m_buf) *m_buf = *m_in->Mixture();
 }
 
 
@@ -428,6 +428,7 @@ void SensitivityAnalyzer::ChangeMechParams()
             }
             m_mech->GasMech().GetReactions(i)->SetArrhenius(arr);
         }
+        m_mech->GasMech().UpdateReactions();
     } else if (m_probType == Init_Conditions) {
         unsigned int i_temp = m_reactor->Mixture()->GasPhase().temperatureIndex();
         unsigned int i_dens = m_reactor->Mixture()->GasPhase().densityIndex();
@@ -468,6 +469,7 @@ void SensitivityAnalyzer::ResetMechParams()
             }
             m_mech->GasMech().GetReactions(i)->SetArrhenius(arr);
         }
+        m_mech->GasMech().UpdateReactions();
     } else if (m_probType == Init_Conditions) {
         unsigned int i_temp = m_reactor->Mixture()->GasPhase().temperatureIndex();
         unsigned int i_dens = m_reactor->Mixture()->GasPhase().densityIndex();
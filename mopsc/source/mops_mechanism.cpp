@@ -53,12 +53,35 @@ Mechanism::Mechanism(void)
 {
 }
 
+// Copy constructor.
+Mechanism::Mechanism(const Mechanism &copy)
+{
+    *this = copy;
+}
+
 // Default destructor.
 Mechanism::~Mechanism(void)
 {
 }
 
 
+// OPERATOR OVERLOADS.
+
+// Assignment operator.
+Mechanism &Mechanism::operator=(const Mechanism &rhs)
+{
+    if (this != &rhs) {
+        m_gmech = rhs.m_gmech;
+        m_pmech = rhs.m_pmech;
+
+        // The particle mechanism must use the species of this
+        // gas mechanism, not those of the one being copied.
+        m_pmech.SetSpecies(m_gmech.Species());
+    }
+    return *this;
+}
+
+
 // PARTICLE MECHANISM.
 
 // READ/WRITE/COPY FUNCTIONS.
@@ -38,6 +38,7 @@
 
 #include <boost/functional/hash.hpp>
 #include <boost/random/mersenne_twister.hpp>
+#include <map>
 
 namespace Mops {
 
@@ -53,7 +54,8 @@ NetworkSimulator::NetworkSimulator(
 : mRuns(sim.RunCount()),
   mFileBase("net"),
   mTimes(times),
-  mSimInitial(NULL) {
+  mSimInitial(NULL),
+  mMode(Serial_Steps) {
     // Create a simulator copy
     mSimInitial = new Mops::Simulator(sim);
 }
@@ -66,6 +68,7 @@ NetworkSimulator::~NetworkSimulator() {
     // given by the second element of the pair
     for (NetworkSimulator::s_iter it=NetworkSimulator::Begin();
             it != NetworkSimulator::End(); ++it) {
+        UnbindMechanism(*it);
         delete it->sim;
         delete it->sol;
     }
@@ -99,6 +102,25 @@ void NetworkSimulator::Run(
     // Initialise the simulator if it is not done already
     if (mSimulators.size() < 1) Initialise(net, solver);
 
+    // Decide how the nodes are solved within each step.  Nodes which are
+    // solved concurrently need their own mechanisms, as these hold the
+    // rate workspaces and process counters, and read their upstream
+    // nodes through buffered streams.
+    StepMode mode = mMode;
+    if ((mode != Serial_Steps) && !CanStepConcurrently()) mode = Serial_Steps;
+    const Wavefronts waves = FindWavefronts(mode);
+    for (it=this->Begin(); it!=this->End(); ++it) {
+        if ((mode != Serial_Steps) && (it->mech == NULL)) {
+            BindMechanism(*it, net);
+            it->sol->Initialise(*(it->reac));
+        }
+        const Mops::FlowPtrVector &iptrs = it->reac->Inflows();
+        for (Mops::FlowPtrVector::const_iterator f=iptrs.begin(); f!=iptrs.end(); ++f) {
+            (*f)->SetBuffered(mode != Serial_Steps);
+        }
+    }
+    const unsigned int nthreads = mSimInitial->ThreadCount();
+
     // Write auxiliary file
     mSimInitial->writeAux(*(net.Mechanism()), *(&mTimes), solver);
 
@@ -118,6 +140,16 @@ void NetworkSimulator::Run(
         boost::hash_combine(iseed, i);
         boost::mt19937 rng(iseed);
 
+        // Independent random number streams for nodes solved concurrently
+        std::vector<Sweep::rng_type> node_rngs;
+        if (mode != Serial_Steps) {
+            for (unsigned int k(0u); k!=mSimulators.size(); ++k) {
+                std::size_t nseed = iseed;
+                boost::hash_combine(nseed, k);
+                node_rngs.push_back(Sweep::rng_type(nseed));
+            }
+        }
+
         Mops::timevector::const_iterator iint;
         unsigned int istep(0u), global_step(0u);
         double dt, t2;
@@ -183,22 +215,48 @@ void NetworkSimulator::Run(
                 t2 += dt;
 
                 // Run the solver
-                for (it=this->Begin(); it!=this->End(); ++it) {
-
-                    it->sim->m_cpu_mark = std::clock();
-                    it->sol->Solve(*(it->reac), t2, iint->SplittingStepCount(),
-                            it->sim->m_niter, rng, &Mops::Simulator::fileOutput,
-                            (void*)(it->sim));
-
-                    std::cout << it->reac->GetName() << " done. " << std::endl;
-
-                    // Do LOI calculation here
-                    if (it->sol->GetLOIStatus()) {
-                        it->sim->solveLOIJacobian(
-                                *(it->reac),
-                                *(it->sol),
-                                istep,
-                                t2);
+                if (mode == Serial_Steps) {
+                    for (it=this->Begin(); it!=this->End(); ++it) {
+                        SolveNode(*it, t2, iint->SplittingStepCount(), istep, rng);
+                    }
+                } else {
+                    for (Wavefronts::const_iterator w=waves.begin(); w!=waves.end(); ++w) {
+                        // Refresh the streams read by this wavefront
+                        for (unsigned int k(0u); k!=w->size(); ++k) {
+                            const Mops::FlowPtrVector &iptrs =
+                                    mSimulators[(*w)[k]].reac->Inflows();
+                            for (Mops::FlowPtrVector::const_iterator f=iptrs.begin();
+                                    f!=iptrs.end(); ++f) {
+                                (*f)->UpdateBuffer();
+                            }
+                        }
+
+                        // Exceptions cannot leave the parallel region
+                        std::vector<std::string> errors(w->size());
+                        const int nw = (int)w->size();
+
+                        #pragma omp parallel for schedule(dynamic, 1) num_threads(nthreads)
+                        for (int k=0; k<nw; ++k) {
+                            const unsigned int inode = (*w)[k];
+                            try {
+                                SolveNode(mSimulators[inode], t2,
+                                        iint->SplittingStepCount(), istep,
+                                        node_rngs[inode]);
+                            } catch (std::exception &e) {
+                                errors[k] = e.what();
+                            } catch (...) {
+                                errors[k] = "unknown error";
+                            }
+                        }
+
+                        for (unsigned int k(0u); k!=w->size(); ++k) {
+                            if (!errors[k].empty()) {
+                                throw std::runtime_error("Reactor "
+                                        + mSimulators[(*w)[k]].reac->GetName()
+                                        + " failed: " + errors[k]
+                                        + " (Mops, NetworkSimulator::Run).");
+                            }
+                        }
                     }
                 }
 
@@ -258,6 +316,149 @@ void NetworkSimulator::Run(
     }
 }
 
+/*!
+ * @param n         The node to solve
+ * @param t2        End time of the step
+ * @param nsplit    Number of splitting steps
+ * @param istep     Index of the step within its interval
+ * @param rng       Random number generator of the node
+ */
+void NetworkSimulator::SolveNode(
+        Mops::Node &n,
+        double t2,
+        int nsplit,
+        unsigned int istep,
+        Sweep::rng_type &rng) {
+
+    n.sim->m_cpu_mark = std::clock();
+    n.sol->Solve(*(n.reac), t2, nsplit, n.sim->m_niter, rng,
+            &Mops::Simulator::fileOutput, (void*)(n.sim));
+
+    std::cout << n.reac->GetName() << " done. " << std::endl;
+
+    // Do LOI calculation here
+    if (n.sol->GetLOIStatus()) {
+        n.sim->solveLOIJacobian(*(n.reac), *(n.sol), istep, t2);
+    }
+}
+
+/*!
+ * The reactor of the node is bound to the copy, which is owned by the
+ * node.  Particles created while solving the node refer to the copy, so
+ * the network should not be solved again once this simulator is deleted.
+ *
+ * @param n         The node to give a mechanism
+ * @param net       The network whose mechanism is copied
+ */
+void NetworkSimulator::BindMechanism(
+        Mops::Node &n,
+        const Mops::ReactorNetwork &net) {
+    n.netmech = n.reac->Mech();
+    n.mech = new Mops::Mechanism(*net.Mechanism());
+    n.reac->SetMech(*n.mech);
+}
+
+/*!
+ * The reactors belong to the network and outlive the simulator, so they
+ * must not be left referring to a deleted copy of the mechanism.
+ *
+ * @param n     Node whose copy of the mechanism is deleted
+ */
+void NetworkSimulator::UnbindMechanism(Mops::Node &n) {
+    if (n.mech == NULL) return;
+    if (n.netmech != NULL) n.reac->SetMech(*n.netmech);
+    delete n.mech;
+    n.mech = NULL;
+}
+
+/*!
+ * Features which move particles directly into another node, or which
+ * change the particle lists of the upstream nodes, force the nodes to be
+ * solved one after another.
+ *
+ * @return      True if the nodes may be solved concurrently
+ */
+bool NetworkSimulator::CanStepConcurrently() {
+    std::string reason;
+    for (s_iter it=this->Begin(); it!=this->End() && reason.empty(); ++it) {
+        if (it->reac->Mech()->ParticleMech().IsHybrid()) {
+            reason = "the hybrid particle model";
+        } else if (it->reac->Mech()->ParticleMech().AggModel()
+                == Sweep::AggModels::PAH_KMC_ID) {
+            // PAH clones and the KMC jump processes share static state.
+            reason = "the PAH-PP/KMC-ARS model";
+        }
+        const Sweep::Processes::DeathPtrVector &dps = it->reac->Mixture()->Outflows();
+        for (Sweep::Processes::DeathPtrVector::const_iterator d=dps.begin();
+                d!=dps.end(); ++d) {
+            if ((*d)->GetDeathType() == Sweep::Processes::DeathProcess::iContMove
+                    || (*d)->GetDeathType() == Sweep::Processes::DeathProcess::iStochMove) {
+                reason = "moving particles between reactors";
+            }
+        }
+    }
+
+    if (reason.empty()) return true;
+    std::cout << "mops: " << reason << " is not supported with concurrent "
+            "reactors; solving the network serially." << std::endl;
+    return false;
+}
+
+/*!
+ * In the concurrent mode all nodes are solved at once.  In the wavefront
+ * mode a node is placed one wavefront after the latest of its upstream
+ * reactors, so that each wavefront only reads nodes which have completed
+ * the step.  A network with a recycle loop has no such order, and is
+ * solved in the concurrent mode instead.
+ *
+ * @param mode      How the nodes are solved
+ * @return          Indices of the nodes in each wavefront, in solution order
+ */
+NetworkSimulator::Wavefronts NetworkSimulator::FindWavefronts(StepMode mode) {
+    Wavefronts waves;
+    if (mode == Serial_Steps) return waves;
+
+    const unsigned int nnodes = mSimulators.size();
+    std::vector<unsigned int> level(nnodes, 0u);
+
+    if (mode == Wavefront_Steps) {
+        // Index of the node of each reactor
+        std::map<const Mops::PSR*, unsigned int> index;
+        for (unsigned int k(0u); k!=nnodes; ++k) index[mSimulators[k].reac] = k;
+
+        // Relax the levels; an acyclic network converges in fewer passes
+        // than there are nodes.
+        bool changed(true);
+        for (unsigned int pass(0u); changed && (pass<=nnodes); ++pass) {
+            changed = false;
+            for (unsigned int k(0u); k!=nnodes; ++k) {
+                const Mops::FlowPtrVector &iptrs = mSimulators[k].reac->Inflows();
+                for (Mops::FlowPtrVector::const_iterator f=iptrs.begin();
+                        f!=iptrs.end(); ++f) {
+                    if (!(*f)->HasReacInflow()) continue;
+                    const unsigned int u = index[(*f)->Inflow()];
+                    if (level[k] < level[u] + 1) {
+                        level[k] = level[u] + 1;
+                        changed = true;
+                    }
+                }
+            }
+        }
+
+        if (changed) {
+            std::cout << "mops: Recycle loop in network; solving all reactors "
+                    "concurrently." << std::endl;
+            level.assign(nnodes, 0u);
+        }
+    }
+
+    for (unsigned int k(0u); k!=nnodes; ++k) {
+        if (level[k] >= waves.size()) waves.resize(level[k] + 1);
+        waves[level[k]].push_back(k);
+    }
+    return waves;
+}
+
 /*!
  * Create the data structure for each reactor 'node' in the network. Each
  * reactor is assigned to a Mops::Node containing the reactor, its own solver
@@ -280,6 +481,14 @@ void NetworkSimulator::Initialise(
         sim = NetworkSimulator::CreateSimulator(*it);
         sim->SetTimeVector(mTimes);
 
+        // Now create a new node
+        Mops::Node n;
+        n.sim = sim;
+        n.reac = *it;
+
+        // Nodes solved concurrently have their own mechanism
+        if (mMode != Serial_Steps) BindMechanism(n, net);
+
         // Create a solver and initialise it
         isol = solver.Clone();
         isol->Initialise(*(*it));
@@ -288,11 +497,7 @@ void NetworkSimulator::Initialise(
         if (net.Mechanism()->GasMech().ReactionCount() < 1)
             isol->SetLOIStatusFalse();
 
-        // Now create a new node
-        Mops::Node n;
-        n.sim = sim;
         n.sol = isol;
-        n.reac = *it;
 
         // Add it to our simulator paths
         mSimulators.push_back(n);
@@ -48,6 +48,7 @@
 #include "mops_reactor.h"
 #include "mops_rhs_func.h"
 #include "mops_psr.h"
+#include "mops_sparse_linear_solver.h"
 #include "cvodes_utils.h"
 
 // CVODE includes.
@@ -103,6 +104,8 @@ ODE_Solver &ODE_Solver::operator=(const Mops::ODE_Solver &rhs)
         m_reactor  = rhs.m_reactor;
         m_rtol     = rhs.m_rtol;
         m_atol     = rhs.m_atol;
+        m_restart_tol = rhs.m_restart_tol;
+        m_linsolver = rhs.m_linsolver;
         m_neq      = rhs.m_neq;
         m_srcterms = rhs.m_srcterms;
         _srcTerms  = rhs._srcTerms;
@@ -208,7 +211,7 @@ void ODE_Solver::InitCVode(void)
             // CVDenseSetJacFn(m_odewk, jacFn_CVODES, (void*)this); //<== need test
         }
     } else {
-        // CVDlsSetDenseJacFn(m_odewk, &jacFn_CVODE);
+        // The external Jacobian is set in Solve(), once the reactor is known.
     }
 
     if (m_sensi.isEnable()) {
@@ -246,6 +249,43 @@ void ODE_Solver::ResetSolver(void)
     
 } 
 
+// Restarts the solver after the reactor contents have been changed
+// between calls to Solve().  CVODE holds the solution at the last
+// time reached as the first column of its history array; if the
+// reactor state is close to it then that column is overwritten and
+// the higher columns, step size, order and Jacobian are kept.
+void ODE_Solver::RestartSolver(void)
+{
+    CVodeMem cv_mem = (CVodeMem)m_odewk;
+    if ((m_restart_tol <= 0.0) || m_sensi.isEnable() || (cv_mem->cv_nst == 0)) {
+        ResetSolver();
+        return;
+    }
+
+    // The last solve may have stopped within round-off of its stop time.
+    const double troundoff = 100.0 * cv_mem->cv_uround *
+                             (fabs(cv_mem->cv_tn) + fabs(cv_mem->cv_h));
+    if (fabs(cv_mem->cv_tn - m_time) > troundoff) {
+        ResetSolver();
+        return;
+    }
+
+    // Weighted RMS norm of the change of state.
+    double *const zn0 = NV_DATA_S(cv_mem->cv_zn[0]);
+    const double *const ewt = NV_DATA_S(cv_mem->cv_ewt);
+    double sum = 0.0;
+    for (unsigned int i=0; i!=m_neq; ++i) {
+        const double d = (m_soln[i] - zn0[i]) * ewt[i];
+        sum += d * d;
+    }
+
+    if (sqrt(sum / (double)m_neq) > m_restart_tol) {
+        ResetSolver();
+    } else {
+        memcpy(zn0, m_soln, sizeof(double)*m_neq);
+    }
+}
+
 // Reset the solver.  Need to do this if the the reactor
 // contents has been changed between calls to Solve().
 void ODE_Solver::ResetSolver(Reactor &reac)
@@ -314,6 +354,25 @@ void ODE_Solver::Solve(Reactor &reac, double stop_time)
     NV_DATA_S(m_solvec) = m_soln;
     CVodeSetStopTime(m_odewk, stop_time);
 
+    // Use the analytic gas-phase Jacobian where the reactor supports it,
+    // otherwise fall back on the CVODE difference quotients.  The sparse
+    // linear solver requires the analytic Jacobian.  The external source
+    // terms (_srcTerms) are interpolated in time from m_srcterms and added
+    // to the reactor RHS; SrcTermFnPtr is not given the solution, so their
+    // derivatives with respect to it are zero and the reactor Jacobian is
+    // that of the full RHS.  A source term that depended on the solution
+    // would have to be differenced here.
+    if (!m_sensi.isEnable()) {
+        if ((m_linsolver == Sparse_Solver) && reac.HasAnalyticJacobian()) {
+            if (!SparseLinearSolver::IsAttached(m_odewk))
+                SparseLinearSolver::Attach(m_odewk);
+        } else {
+            if (SparseLinearSolver::IsAttached(m_odewk))
+                CVDense(m_odewk, m_neq);
+            CVDlsSetDenseJacFn(m_odewk, reac.HasAnalyticJacobian() ? &jacFn_CVODE : NULL);
+        }
+    }
+
     // Solve over time step.
     while (m_time < stop_time) {
         int CVode_error = 0;
@@ -432,6 +491,35 @@ void ODE_Solver::SetRTOL(double rtol)
 }
 
 
+double ODE_Solver::RestartTolerance() const
+{
+    return m_restart_tol;
+}
+
+void ODE_Solver::SetRestartTolerance(double tol)
+{
+    m_restart_tol = tol;
+}
+
+
+// LINEAR SOLVER.
+
+ODE_Solver::LinearSolverType ODE_Solver::LinearSolver() const
+{
+    return m_linsolver;
+}
+
+void ODE_Solver::SetLinearSolver(LinearSolverType type)
+{
+    m_linsolver = type;
+}
+
+const SparseLinearSolver *ODE_Solver::SparseSolver() const
+{
+    return SparseLinearSolver::Find(m_odewk);
+}
+
+
 // EXTERNAL SOURCE TERMS.
 
 // Returns the vector of external source terms (const version).
@@ -474,8 +562,8 @@ void ODE_Solver::Serialize(std::ostream &out) const
     const unsigned int falseval = 0;
     
     if (out.good()) {
-        // Output the version ID (=0 at the moment).
-        const unsigned int version = 0;
+        // Output the version ID (=2 at the moment).
+        const unsigned int version = 2;
         out.write((char*)&version, sizeof(version));
 
         // Output the time.
@@ -503,6 +591,14 @@ void ODE_Solver::Serialize(std::ostream &out) const
         } else {
             out.write((char*)falseval, sizeof(falseval));
         }
+
+        // Output the linear solver.
+        n = (unsigned int)m_linsolver;
+        out.write((char*)&n, sizeof(n));
+
+        // Output the restart tolerance.
+        val = (double)m_restart_tol;
+        out.write((char*)&val, sizeof(val));
     } else {
         throw invalid_argument("Output stream not ready (Mops, Reactor::Serialize).");
     }
@@ -526,6 +622,8 @@ void ODE_Solver::Deserialize(std::istream &in)
 
         switch (version) {
             case 0:
+            case 1:
+            case 2:
                 // Read the time.
                 in.read(reinterpret_cast<char*>(&val), sizeof(val));
                 m_time = (double)val;
@@ -552,6 +650,18 @@ void ODE_Solver::Deserialize(std::istream &in)
                     }
                 }
 
+                // Read the linear solver.
+                if (version > 0) {
+                    in.read(reinterpret_cast<char*>(&n), sizeof(n));
+                    m_linsolver = (LinearSolverType)n;
+                }
+
+                // Read the restart tolerance.
+                if (version > 1) {
+                    in.read(reinterpret_cast<char*>(&val), sizeof(val));
+                    m_restart_tol = (double)val;
+                }
+
                 break;
             default:
                 throw runtime_error("Solver serialized version number "
@@ -578,6 +688,8 @@ void ODE_Solver::init(void)
     m_solvec   = NULL;
     m_atol     = 1.0e-6;
     m_rtol     = 1.0e-3;
+    m_restart_tol = 0.0;
+    m_linsolver = Dense_Solver;
     m_neq      = 0;
     m_srcterms = NULL;
     _srcTerms  = NULL;
@@ -606,4 +606,15 @@ void PSR::RHS_Adiabatic(double t, const double *const y,  double *ydot) const
     PSR::RHS_Complete(t, y, ydot);
 }
 
+/*!
+ * The gas-phase Jacobian of the base class does not include the inflow
+ * and outflow terms, so the ODE solver keeps its own difference quotients.
+ *
+ * @return      Always false
+ */
+bool PSR::HasAnalyticJacobian() const
+{
+    return false;
+}
+
 } // Mops namespace
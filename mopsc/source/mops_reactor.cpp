@@ -122,6 +122,18 @@ Reactor &Reactor::operator=(const Mops::Reactor &rhs)
         m_iT      = rhs.m_iT;
         m_iDens   = rhs.m_iDens;
         m_include_particle_terms = rhs.m_include_particle_terms;
+        m_constv  = rhs.m_constv;
+        m_Tfunc   = rhs.m_Tfunc;
+        m_sarea   = rhs.m_sarea;
+        m_svol    = rhs.m_svol;
+        m_name    = rhs.m_name;
+
+        // Copy the temperature gradient profile.
+        m_dTdt_profile.clear();
+        std::map<double, Sweep::Maths::Functional*>::const_iterator i;
+        for (i=rhs.m_dTdt_profile.begin(); i!=rhs.m_dTdt_profile.end(); ++i) {
+            m_dTdt_profile[i->first] = i->second->Clone();
+        }
 
         // Initialise the reactor with the mechanism.
         SetMech(*rhs.m_mech);
@@ -233,6 +245,11 @@ void Reactor::SetMech(const Mops::Mechanism &mech)
     // Allocate the derivative array.
     if (m_deriv != NULL) delete [] m_deriv;
     m_deriv = new double[m_neq];
+
+    // Allocate the RHS workspace.
+    m_wdot.resize(m_nsp, 0.0);
+    m_sdot.resize(m_nsp, 0.0);
+    m_Hs.resize(m_nsp, 0.0);
 }
 
 // ENERGY MODEL.
@@ -512,7 +529,7 @@ unsigned int Reactor::ODE_Count() const
 // Definition of RHS form for constant temperature energy equation.
 void Reactor::RHS_ConstT(double t, const double *const y,  double *ydot) const
 {
-    static fvector wdot, sdot;
+    fvector &wdot = m_wdot, &sdot = m_sdot;
     double wtot = 0.0, stot= 0.0;
 
 	
@@ -578,7 +595,7 @@ void Reactor::RHS_ConstT(double t, const double *const y,  double *ydot) const
  */
 void Reactor::RHS_Adiabatic(double t, const double *const y,  double *ydot) const
 {
-    static fvector wdot, sdot, Hs;
+    fvector &wdot = m_wdot, &sdot = m_sdot, &Hs = m_Hs;
     double wtot = 0.0, stot = 0.0, C = 0.0;
 //	Sweep::AggModels::Primary *m_prim;
 //	m_prim->SurfaceArea();
@@ -670,6 +687,33 @@ void Reactor::Jacobian(double t, double *const y,
                                      m_constv, m_emodel==ConstT);
 }
 
+// Returns true if Jacobian() is exact enough to be given to the ODE
+// solver.  Imposed temperature gradients and surface reactions are
+// not included in the gas-phase Jacobian.
+bool Reactor::HasAnalyticJacobian() const
+{
+    return (m_Tfunc == NULL) && (m_sarea <= 0.0) &&
+           m_mech->GasMech().Reactions().HasAnalyticJacobian();
+}
+
+// Returns the sparsity pattern of the species block of the analytic
+// Jacobian.
+void Reactor::JacobianSparsity(std::vector<unsigned int> &start,
+                               std::vector<unsigned int> &rows) const
+{
+    m_mech->GasMech().Reactions().JacobianSparsity(start, rows);
+}
+
+// Calculates the analytic Jacobian in bordered sparse form.
+void Reactor::SparseJacobian(double t, double *const y,
+                             Sprog::Kinetics::SparseJacobian &J,
+                             double uround) const
+{
+    m_mech->GasMech().Reactions().CalcSparseJacobian(y[m_iT], y[m_iDens], y,
+                                     m_nsp, m_mix->GasPhase(), uround, J,
+                                     m_constv, m_emodel==ConstT);
+}
+
 /*!
 @param[in]          t       Time step
 @param[in]          y       solution vector with mole fractions and density and temperature
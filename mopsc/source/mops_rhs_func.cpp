@@ -128,7 +128,8 @@ int jacFn_CVODE(long int N,
     Mops::ODE_Solver *s = static_cast<Mops::ODE_Solver*>(solver);
     Mops::Reactor *r    = s->GetReactor();
 
-    // Get the Jacobian from the reactor model
+    // Get the Jacobian from the reactor model.  The solver's external
+    // source terms depend on time only, so they add nothing to it.
     r->Jacobian(t, NV_DATA_S(y), J->cols, 
                 UNIT_ROUNDOFF);
 
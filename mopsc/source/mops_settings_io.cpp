@@ -54,6 +54,7 @@
 #include <sstream>
 #include <memory>
 #include <cstdlib>
+#include <limits>
 
 using namespace Mops;
 
@@ -162,12 +163,39 @@ void readGlobalSettings(const CamXML::Element &node,
         solver.SetATOL(Strings::cdble(subnode->Data()));
     }
 
+    // Read the tolerance for warm restarts of the ODE solver between
+    // splitting steps.
+    subnode = node.GetFirstChild("restarttol");
+    if (subnode != NULL) {
+        solver.SetRestartTolerance(Strings::cdble(subnode->Data()));
+    }
+
+    // Read the linear solver used by the ODE solver.
+    subnode = node.GetFirstChild("linsolver");
+    if (subnode != NULL) {
+        const std::string ls = subnode->Data();
+        if (ls.compare("dense") == 0) {
+            solver.SetLinearSolver(ODE_Solver::Dense_Solver);
+        } else if (ls.compare("sparse") == 0) {
+            solver.SetLinearSolver(ODE_Solver::Sparse_Solver);
+        } else {
+            throw std::runtime_error("Unknown linear solver " + ls
+                    + " (::readGlobalSettings).");
+        }
+    }
+
     // Read the number of runs.
     subnode = node.GetFirstChild("runs");
     if (subnode != NULL) {
         sim.SetRunCount((int)Strings::cdble(subnode->Data()));
     }
 
+    // Read the number of threads over which the runs are distributed.
+    subnode = node.GetFirstChild("threads");
+    if (subnode != NULL) {
+        sim.SetThreadCount((int)Strings::cdble(subnode->Data()));
+    }
+
     // Read the number of iterations.
     subnode = node.GetFirstChild("iter");
     if (subnode != NULL) {
@@ -186,6 +214,12 @@ void readGlobalSettings(const CamXML::Element &node,
         sim.SetMaxM0(Strings::cdble(subnode->Data())*1.0e6); // Convert from #/cm3 to #/m3.
     }
 
+    // Read the limit on the gas-phase change per adaptive splitting step.
+    subnode = node.GetFirstChild("gaschangetol");
+    if (subnode != NULL) {
+        solver.SetGasChangeTolerance(Strings::cdble(subnode->Data()));
+    }
+
     // Read predictor-corrector relaxation parameter.
     subnode = node.GetFirstChild("relax");
     if (subnode != NULL) {
@@ -193,6 +227,55 @@ void readGlobalSettings(const CamXML::Element &node,
     }
 }
 
+/*!
+ * Reads the temperature ranges outside which gas-phase reactions are
+ * switched off, given as
+ *     <temperaturerange rxnth="12" min="300" max="2000"/>
+ * The rxnth attribute is the zero-based reaction index; without it the
+ * range applies to all reactions.  Either limit may be omitted.
+ *
+ *\param[in]        node        XML node containing the settings
+ *\param[in,out]    mech        Mechanism whose reactions are limited
+ *
+ *\exception    std::runtime_error  Reaction index out of range
+ */
+void readTemperatureRanges(const CamXML::Element &node, Mechanism &mech)
+{
+    std::vector<CamXML::Element*> nodes;
+    std::vector<CamXML::Element*>::const_iterator i;
+    const CamXML::Attribute *attr;
+
+    node.GetChildren("temperaturerange", nodes);
+    if (nodes.empty()) return;
+
+    const unsigned int nrxn = mech.GasMech().ReactionCount();
+    for (i=nodes.begin(); i!=nodes.end(); ++i) {
+        double tmin = 0.0;
+        double tmax = std::numeric_limits<double>::max();
+
+        attr = (*i)->GetAttribute("min");
+        if (attr != NULL) tmin = Strings::cdble(attr->GetValue());
+        attr = (*i)->GetAttribute("max");
+        if (attr != NULL) tmax = Strings::cdble(attr->GetValue());
+
+        attr = (*i)->GetAttribute("rxnth");
+        if (attr != NULL) {
+            const int j = (int)Strings::cdble(attr->GetValue());
+            if ((j < 0) || ((unsigned int)j >= nrxn)) {
+                throw std::runtime_error("Temperature range given for unknown reaction"
+                                         " (Mops::Settings_IO::readTemperatureRanges).");
+            }
+            mech.GasMech().GetReactions(j)->SetTemperatureRange(tmin, tmax);
+        } else {
+            for (unsigned int j=0; j!=nrxn; ++j) {
+                mech.GasMech().GetReactions(j)->SetTemperatureRange(tmin, tmax);
+            }
+        }
+    }
+
+    mech.GasMech().UpdateReactions();
+}
+
 
 /*!
  * @brief           Helper function to determine if coag kernels are compatible
@@ -842,6 +925,13 @@ Reactor *const readReactor(const CamXML::Element &node,
         } else reac->Mixture()->Particles().SetDoubling(true);
     }
 
+    // Fraction of changed particles above which the ensemble tree is rebuilt
+    subnode = node.GetFirstChild("treerebuild");
+    if (subnode != NULL) {
+        reac->Mixture()->Particles().SetRebuildFraction(
+            Strings::cdble(subnode->GetAttributeValue("fraction")));
+    }
+
     // TEMPERATURE GRADIENT PROFILE.
 
     node.GetChildren("dTdt", nodes);
@@ -974,6 +1064,13 @@ void readNetwork(
                     reac->Mixture()->Particles().SetDoubling(false);
                 } else reac->Mixture()->Particles().SetDoubling(true);
             }
+
+            // Fraction of changed particles above which the ensemble tree is rebuilt
+            node = (*i)->GetFirstChild("treerebuild");
+            if (node != NULL) {
+                reac->Mixture()->Particles().SetRebuildFraction(
+                    Strings::cdble(node->GetAttributeValue("fraction")));
+            }
             j++;
 
             // Store the names of the flow
@@ -1332,6 +1429,7 @@ Reactor *const Settings_IO::LoadFromXML(const std::string &filename,
         // GLOBAL SETTINGS.
 
         readGlobalSettings(*root, sim, solver);
+        readTemperatureRanges(*root, mech);
 
         // OUTPUT SETTINGS.
         // wjm34: read output settings before reactor, so we can check if ensemble/g.p.
@@ -1731,6 +1829,7 @@ Mops::ReactorNetwork* Settings_IO::LoadNetwork(
         // GLOBAL SETTINGS.
 
         readGlobalSettings(*root, sim, solver);
+        readTemperatureRanges(*root, mech);
 
         // OUTPUT SETTINGS.
         // wjm34: read output settings before reactor, so we can check if ensemble/g.p.
@@ -48,11 +48,14 @@
 #include "mops_ode_solver.h"
 #include "mops_flux_postprocessor.h"
 #include "mops_reactor_factory.h"
+#include "mops_ensemble_snapshot.h"
 #include "string_functions.h"
 #include "csv_io.h"
 #include "geometry1d.h"
 #include <stdexcept>
 #include <memory>
+#include <sstream>
+#include <cstdio>
 #include "gpc_reaction_set.h"
 #include "loi_reduction.h"
 #include "mops_gpc_sensitivity.h"
@@ -73,7 +76,7 @@ using namespace Strings;
 
 // Default constructor.
 Simulator::Simulator(void)
-: m_nruns(1), m_niter(1), m_pcount(0), m_maxm0(0.0),
+: m_nruns(1), m_niter(1), m_nthreads(1), m_pcount(0), m_maxm0(0.0),
   m_cpu_start((clock_t)0.0), m_cpu_mark((clock_t)0.0), m_runtime(0.0),
   m_console_interval(1), m_console_msgs(true),
   m_output_filename("mops-out"), m_output_every_iter(false),
@@ -101,12 +104,16 @@ Simulator &Simulator::operator=(const Mops::Simulator &rhs) {
     if (this != &rhs) {
         m_nruns = rhs.m_nruns;
         m_niter = rhs.m_niter;
+        m_nthreads = rhs.m_nthreads;
+        m_times = rhs.m_times;
         m_pcount = rhs.m_pcount;
         m_maxm0 = rhs.m_maxm0;
         m_cpu_start = rhs.m_cpu_start;
         m_cpu_mark = rhs.m_cpu_mark;
         m_runtime = rhs.m_runtime;
         m_console_interval = rhs.m_console_interval;
+        m_console_vars = rhs.m_console_vars;
+        m_console_mask = rhs.m_console_mask;
         m_console_msgs = rhs.m_console_msgs;
         m_output_filename = rhs.m_output_filename;
         m_output_every_iter = rhs.m_output_every_iter;
@@ -120,7 +127,9 @@ Simulator &Simulator::operator=(const Mops::Simulator &rhs) {
         m_mass_spectra_ensemble = rhs.m_mass_spectra_ensemble;
         m_mass_spectra_xmer = rhs.m_mass_spectra_xmer;
         m_mass_spectra_frag = rhs.m_mass_spectra_frag;
+        m_statbound = rhs.m_statbound;
         m_ptrack_count = rhs.m_ptrack_count;
+        m_flux_elements = rhs.m_flux_elements;
 		m_track_bintree_particle_count = rhs.m_track_bintree_particle_count;
     }
     return *this;
@@ -154,6 +163,12 @@ unsigned int Simulator::TimeStepCount() const
 // Sets the number of iterations to perform per step.
 void Simulator::SetIterCount(unsigned int n) {m_niter = n;}
 
+// Returns the number of threads over which runs are distributed.
+unsigned int Simulator::ThreadCount(void) const {return m_nthreads;}
+
+// Sets the number of threads over which runs are distributed.
+void Simulator::SetThreadCount(unsigned int n) {m_nthreads = (n > 0) ? n : 1;}
+
 // Sets the time vector.
 void Simulator::SetTimeVector(const timevector &times) {m_times = times;}
 
@@ -414,20 +429,53 @@ void Simulator::RunSimulation(Mops::Reactor &r,
     setupConsole(*r.Mech());
 	string m_output_filename_base=m_output_filename;		//ms785
 
-	// Loop over runs.
 	#ifdef USE_MPI
+
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	m_output_filename=m_output_filename_base+cstr(rank);				//ms785
+	openOutputFile();
+
+	// Each MPI process performs the run with the number of its rank.
+	solveRun(r, s, *initmix, rank, seed, m_output_filename_base, icon, true);
+
+	closeOutputFile();			//ms785
+
 	#else
-    for (unsigned int irun=0; irun!=m_nruns; ++irun) {
+
+    // Loop over runs, distributing them over threads if requested.
+    if ((m_nthreads > 1) && (m_nruns > 1) && canRunParallel(r, s)) {
+        runParallel(r, s, *initmix, seed, m_output_filename_base);
+    } else {
+        for (unsigned int irun=0; irun!=m_nruns; ++irun) {
+            solveRun(r, s, *initmix, irun, seed, m_output_filename_base, icon, true);
+        }
+    }
+
+    // Close the output files.
+    closeOutputFile();
 	#endif
 
-		#ifdef USE_MPI
+    // If we have a PSR, clear any stream memory.
+    if (r.SerialType() == Mops::Serial_PSR) {
+        Mops::PSR* psr = dynamic_cast<Mops::PSR *>(&r);
+        psr->ClearStreamMemory();
+    }
+}
 
-		MPI_Comm_rank(MPI_COMM_WORLD, &rank);
-		int irun=rank;
-		m_output_filename=m_output_filename_base+cstr(rank);				//ms785
-		openOutputFile();
+// Performs a single run of the simulation on the given reactor, which
+// is refilled with a copy of the initial mixture.  The output file must
+// already be open.
+void Simulator::solveRun(Mops::Reactor &r, Solver &s, const Mixture &initmix,
+                         unsigned int irun, size_t seed,
+                         const std::string &basename, unsigned int &icon,
+                         bool console)
+{
+    double dt, t2; // Stop time for each step.
 
-		#endif
+	#ifdef USE_MPI
+	int rank;
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	#endif
 
 		size_t runSeed = seed;
 		boost::hash_combine(runSeed, irun);
@@ -441,15 +489,17 @@ void Simulator::RunSimulation(Mops::Reactor &r,
         t2 = m_times[0].StartTime();
         r.SetTime(t2);
         // also reset the contents of the reactor
-        r.Fill(*(initmix->Clone()), true);
+        r.Fill(*(initmix.Clone()), true);
 
         // Set up the ODE solver for this run.
         s.Reset(r);
 
         // Print initial conditions to the console.
         printf("mops: Run number %d of %d.\n", irun+1, m_nruns);
-        m_console.PrintDivider();
-        consoleOutput(r);
+        if (console) {
+            m_console.PrintDivider();
+            consoleOutput(r);
+        }
 
         unsigned int istep;
 
@@ -513,7 +563,7 @@ void Simulator::RunSimulation(Mops::Reactor &r,
 				if (rank==0)
 				#endif
                 if (--icon == 0) {
-                    consoleOutput(r);
+                    if (console) consoleOutput(r);
                     icon = m_console_interval;
                 }
             } // number of steps
@@ -521,7 +571,7 @@ void Simulator::RunSimulation(Mops::Reactor &r,
             // Create a save point at the end of this time
             // interval.
 
-			m_output_filename=m_output_filename_base;
+			m_output_filename=basename;
 
             //@todo Reinstate fractal dimension calculations for
             // the PAH-PP model
@@ -550,25 +600,125 @@ void Simulator::RunSimulation(Mops::Reactor &r,
 		// currently this function is limited to PAH-PP model
 		// Produce a file named "primary" which stores information of target (criteria are hard-coded) primary particle
 		//r.Mech()->ParticleMech().Mass_pah(r.Mixture()->Particles());
+}
 
-	#ifdef USE_MPI
+// Returns true if the runs for the given reactor and solver may be
+// distributed over threads.  Features which share files or data between
+// runs force the runs to be performed one after another.
+bool Simulator::canRunParallel(const Mops::Reactor &r, const Solver &s) const
+{
+    string reason;
+    if (s.GetLOIStatus()) {
+        reason = "LOI reduction";
+    } else if (m_track_bintree_particle_count > 0) {
+        reason = "particle tracking for videos";
+    } else if (r.SerialType() == Mops::Serial_PSR) {
+        reason = "PSR inflow and outflow streams";
+    } else if (r.Mech()->ParticleMech().AggModel() == Sweep::AggModels::PAH_KMC_ID) {
+        // PAH clones and the KMC jump processes share static state.
+        reason = "the PAH-PP/KMC-ARS model";
+    } else {
+        return true;
+    }
+
+    printf("mops: %s is not supported with multiple threads; "
+           "performing runs serially.\n", reason.c_str());
+    return false;
+}
+
+// Performs all runs, distributing them over m_nthreads threads.  Each run
+// works on its own copy of the mechanism, reactor, solver and simulator
+// and writes to its own part of the output file.  The parts are appended
+// to the output file in run order once all runs have completed, so the
+// output file is identical to that of a serial simulation.
+void Simulator::runParallel(const Mops::Reactor &r, const Solver &s,
+                            const Mixture &initmix, size_t seed,
+                            const std::string &basename)
+{
+    // Serialise the initial mixture once so that each run can read
+    // its own copy bound to its own particle mechanism.
+    std::stringstream mixdata(ios_base::in | ios_base::out | ios_base::binary);
+    initmix.Serialize(mixdata);
+    const string mixstr = mixdata.str();
+
+    printf("mops: Performing %d runs on %d threads.\n", m_nruns, m_nthreads);
+
+    // Error messages from each run, as exceptions cannot leave the
+    // parallel region.
+    vector<string> errors(m_nruns);
+    const int nruns = (int)m_nruns;
+
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(m_nthreads)
+    for (int irun=0; irun<nruns; ++irun) {
+        try {
+            // Copy the mechanism, as it holds the jump counters and
+            // the rate calculation workspaces.
+            Mops::Mechanism mech(*r.Mech());
+
+            // Copy the reactor and bind it to the copied mechanism.
+            std::auto_ptr<Reactor> rrun(r.Clone());
+            rrun->SetMech(mech);
+
+            // Read the initial mixture against the copied mechanism.
+            std::istringstream in(mixstr, ios_base::in | ios_base::binary);
+            Mixture mix(in, mech.ParticleMech());
+            mix.Particles().SetRebuildFraction(initmix.Particles().RebuildFraction());
+
+            // Copy the solver and set it up for the copied reactor.
+            std::auto_ptr<Solver> srun(s.Clone());
+            srun->Initialise(*rrun);
+
+            // Copy the simulator and open the part output files.
+            Simulator sim(*this);
+            sim.m_output_filename = partFileName(basename, irun);
+            sim.openOutputFile();
+            sim.m_output_filename = basename;
+
+            unsigned int icon = m_console_interval;
+            sim.solveRun(*rrun, *srun, mix, irun, seed, basename, icon, false);
+            sim.closeOutputFile();
+        } catch (std::exception &e) {
+            errors[irun] = e.what();
+        } catch (...) {
+            errors[irun] = "unknown error";
+        }
+    }
 
-		 closeOutputFile();			//ms785
-	#else
-	} // (number of runs)
-	#endif
+    // Append the output of each run to the output files in run order.
+    for (unsigned int irun=0; irun!=m_nruns; ++irun) {
+        if (!errors[irun].empty()) {
+            throw runtime_error("Run " + cstr(irun+1) + " failed: " + errors[irun] +
+                                " (Mops, Simulator::runParallel).");
+        }
 
-	#ifdef USE_MPI
-	#else
-    // Close the output files.
-    closeOutputFile();
-	#endif
+        const string part = partFileName(basename, irun);
+        appendPartFile(part + ".sim", m_file);
+        appendPartFile(part + ".sen", m_senfile);
+    }
+}
 
-    // If we have a PSR, clear any stream memory.
-    if (r.SerialType() == Mops::Serial_PSR) {
-        Mops::PSR* psr = dynamic_cast<Mops::PSR *>(&r);
-        psr->ClearStreamMemory();
+// Returns the base name of the part output files for the given run.
+std::string Simulator::partFileName(const std::string &basename, unsigned int irun)
+{
+    return basename + "-part(" + cstr(irun) + ")";
+}
+
+// Appends the contents of the given file to the output stream and
+// deletes the file.
+void Simulator::appendPartFile(const std::string &fname, std::fstream &out)
+{
+    ifstream in(fname.c_str(), ios_base::in | ios_base::binary);
+    if (!in.good()) {
+        throw runtime_error("Failed to open part output file " + fname +
+                            " (Mops, Simulator::appendPartFile).");
+    }
+
+    // An empty part file would set the failbit on the output stream.
+    if (in.peek() != ifstream::traits_type::eof()) {
+        out << in.rdbuf();
     }
+    in.close();
+    remove(fname.c_str());
 }
 
 /*!
@@ -1065,11 +1215,11 @@ void Simulator::outputGasRxnRates(const Reactor &r) const
 {
     if(r.Mech()->GasMech().ReactionCount() > 0) {
         // Calculate the rates-of-progress.
-        static fvector rop, rfwd, rrev;
+        fvector rop, rfwd, rrev;
         r.Mech()->GasMech().Reactions().GetRatesOfProgress(r.Mixture()->GasPhase(), rop, rfwd, rrev); // GetRatesOfProgress 6
 
         // Calculate the molar production rates.
-        static fvector wdot, sdot;
+        fvector wdot, sdot;
         r.Mech()->GasMech().Reactions().GetMolarProdRates(rop, wdot);
 	r.Mech()->GasMech().Reactions().GetSurfaceMolarProdRates(rop, sdot); // added by mm864
         // Write rates to the file.
@@ -1087,15 +1237,15 @@ void Simulator::outputPartRxnRates(const Reactor &r) const
 {
     if (r.Mech()->ParticleMech().ProcessCount() != 0) {
         // Calculate the process rates.
-        static fvector rates;
+        fvector rates;
         r.Mech()->ParticleMech().CalcRates(r.Time(), *r.Mixture(), Geometry::LocalGeometry1d(), rates);
 
         // Calculate the molar production rates (mol/mol).
-        static fvector wdot;
+        fvector wdot;
         r.Mech()->ParticleMech().CalcGasChangeRates(r.Time(), *r.Mixture(), Geometry::LocalGeometry1d(), wdot);
 
         // Calculate the number of jumps (-).
-        static fvector jumps;
+        fvector jumps;
         r.Mech()->ParticleMech().CalcJumps(r.Time(), *r.Mixture(), Geometry::LocalGeometry1d(), jumps);
 
         // Now convert from mol/mol to mol/m3.
@@ -1265,7 +1415,7 @@ void Simulator::setupConsole(const Mops::Mechanism &mech)
 void Simulator::consoleOutput(const Mops::Reactor &r) const
 {
     // Get output data from gas-phase.
-    static vector<double> out;
+    vector<double> out;
     r.Mixture()->GasPhase().GetConcs(out);
     out.push_back(r.Mixture()->GasPhase().Temperature());
     out.push_back(r.Mixture()->GasPhase().Density());
@@ -2305,6 +2455,23 @@ void Simulator::createSavePoint(const Reactor &r, unsigned int step,
         throw runtime_error("Failed to open file for save point "
                             "output (Mops, Simulator::createSavePoint).");
     }
+
+    // Write the ensemble snapshot used by the PSL post-processing.  The
+    // PSL is taken at the end time of the interval which ends at this
+    // step, and the primary tables are only needed at the last one.
+    double t = r.Time();
+    bool last = false;
+    unsigned int nsteps = 0;
+    for (unsigned int i = 0; i != m_times.size(); ++i) {
+        nsteps += m_times[i].StepCount();
+        if (nsteps == step) {
+            t = m_times[i].EndTime();
+            last = (i == m_times.size() - 1);
+            break;
+        }
+    }
+    EnsembleSnapshot::Write(m_output_filename + "(" + cstr(run) + ")-SP(" +
+                            cstr(step) + ").csp", r, step, run, t, last);
 }
 
 /*!
@@ -2448,12 +2615,33 @@ void Simulator::postProcessPSLs(const Mechanism &mech,
 
 		// Loop over all runs.
 		for (unsigned int irun = 0; irun != m_nruns; ++irun) {
+			double scale = (double)m_nruns;
+			if (m_output_every_iter) scale *= (double)m_niter;
+
+			// Use the ensemble snapshot if it holds everything needed
+			// here, otherwise fall back to the full save point.
+			EnsembleSnapshot snap;
+			if ((m_ptrack_count == 0) &&
+				snap.Open(m_output_filename + "(" + cstr(irun) + ")-SP(" +
+						  cstr(step) + ").csp") &&
+				(snap.Step() == step) && (snap.Run() == irun) &&
+				((i != times.size() - 1) || snap.HasPrimaries())) {
+				for (unsigned int j = 0; j != snap.ParticleCount(); ++j) {
+					snap.PSL(j, 1.0 / (snap.SampleVolume()*scale), psl);
+					out[i]->Write(psl);
+				}
+
+				if (i == times.size() - 1) {
+					snap.GetNodes(nodes);
+					snap.GetPrimaries(prims);
+				}
+				continue;
+			}
+
 			// Read the save point for this step and run.
 			r = readSavePoint(step, irun, mech);
 
 			if (r != NULL) {
-				double scale = (double)m_nruns;
-				if (m_output_every_iter) scale *= (double)m_niter;
 				// Note for hybrid model: particles in list not added here.
 
 				// Get PSL for all particles.
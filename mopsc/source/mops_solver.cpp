@@ -57,7 +57,8 @@ using namespace Strings;
 // Default constructor.
 Solver::Solver(void)
 : m_atol(1.0e-3), m_rtol(6.0e-4),
-  m_LOIEnable(false), m_rlx_coeff(0.0),
+  m_restart_tol(0.0), m_linsolver(ODE_Solver::Dense_Solver),
+  m_LOIEnable(false), m_rlx_coeff(0.0), m_gas_change_tol(0.0),
   m_cpu_start((clock_t)0.0), m_cpu_mark((clock_t)0.0),
   m_tottime(0.0), m_chemtime(0.0)
 {
@@ -73,9 +74,12 @@ Solver::Solver(const Mops::Solver &sol)
 : m_ode(sol.m_ode),
   m_atol(sol.m_atol),
   m_rtol(sol.m_rtol),
+  m_restart_tol(sol.m_restart_tol),
+  m_linsolver(sol.m_linsolver),
   m_LOIEnable(sol.m_LOIEnable),
   m_LOIComp(sol.m_LOIComp),
   m_rlx_coeff(sol.m_rlx_coeff),
+  m_gas_change_tol(sol.m_gas_change_tol),
   Kept_Spec(sol.Kept_Spec),
   m_cpu_start(sol.m_cpu_start),
   m_cpu_mark(sol.m_cpu_mark),
@@ -97,6 +101,8 @@ void Solver::Initialise(Reactor &r)
     m_ode.Initialise(r);
     m_ode.SetATOL(m_atol);
     m_ode.SetRTOL(m_rtol);
+    m_ode.SetRestartTolerance(m_restart_tol);
+    m_ode.SetLinearSolver(m_linsolver);
 }
 
 // Resets the solver to solve the given reactor.
@@ -106,6 +112,8 @@ void Solver::Reset(Reactor &r)
     m_ode.ResetSolver(r);
     m_ode.SetATOL(m_atol);
     m_ode.SetRTOL(m_rtol);
+    m_ode.SetRestartTolerance(m_restart_tol);
+    m_ode.SetLinearSolver(m_linsolver);
 }
 
 
@@ -133,6 +141,32 @@ void Solver::SetRTOL(double rtol)
     m_ode.SetRTOL(rtol);
 }
 
+
+double Solver::RestartTolerance() const
+{
+    return m_restart_tol;
+}
+
+void Solver::SetRestartTolerance(double tol)
+{
+    m_restart_tol = tol;
+    m_ode.SetRestartTolerance(tol);
+}
+
+
+// LINEAR SOLVER.
+
+ODE_Solver::LinearSolverType Solver::LinearSolver() const
+{
+    return m_linsolver;
+}
+
+void Solver::SetLinearSolver(ODE_Solver::LinearSolverType type)
+{
+    m_linsolver = type;
+    m_ode.SetLinearSolver(type);
+}
+
 /*!
 Sets the solver status to true
 */
@@ -204,6 +238,18 @@ double Solver::UnderRelaxCoeff(void) const
 void Solver::SetUnderRelaxCoeff(double relax) {m_rlx_coeff = relax;}
 
 
+// SPLITTING STEP CONTROL.
+
+// Returns the limit on the gas-phase change per splitting step.
+double Solver::GasChangeTolerance(void) const
+{
+    return m_gas_change_tol;
+}
+
+// Sets the limit on the gas-phase change per splitting step.
+void Solver::SetGasChangeTolerance(double tol) {m_gas_change_tol = tol;}
+
+
 // SOLVING REACTORS.
 
 // Runs the solver for the given reactor, advancing it
@@ -0,0 +1,334 @@
+ /*!
+  * @file   mops_sparse_linear_solver.cpp
+  * @brief  Implementation of the sparse direct linear solver for CVODE
+  *
+  *   Licence:
+  *      mops is free software; you can redistribute it and/or
+  *      modify it under the terms of the GNU Lesser General Public License
+  *      as published by the Free Software Foundation; either version 2
+  *      of the License, or (at your option) any later version.
+  *
+  *      This program is distributed in the hope that it will be useful,
+  *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *      GNU Lesser General Public License for more details.
+  *
+  *      You should have received a copy of the GNU Lesser General Public
+  *      License along with this program; if not, write to the Free Software
+  *      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+  *      02111-1307, USA.
+  *
+  *   Contact:
+  *      Prof Markus Kraft
+  *      Dept of Chemical Engineering
+  *      University of Cambridge
+  *      New Museums Site
+  *      Pembroke Street
+  *      Cambridge
+  *      CB2 3RA, UK
+  *
+  *      Email:       mk306@cam.ac.uk
+  *      Website:     http://como.cheng.cam.ac.uk
+  */
+#include "mops_sparse_linear_solver.h"
+#include "mops_ode_solver.h"
+#include "mops_reactor.h"
+
+#include <cmath>
+#include <ctime>
+
+using namespace Mops;
+
+namespace
+{
+    //! Maximum number of steps between Jacobian evaluations (as CVDense)
+    const long int MaxStepsBetweenJac = 50;
+
+    //! Maximum change in gamma for which a bad Jacobian is reused (as CVDense)
+    const double MaxGammaChange = 0.2;
+}
+
+//! Default constructor
+SparseLinearSolver::SparseLinearSolver()
+: m_mech(NULL), m_nsp(0), m_nstlj(0), m_nje(0), m_nfact(0), m_tfact(0.0)
+{}
+
+/*!
+ * Any linear solver already attached is released first.
+ *
+ * @param[in,out]   cvode_mem   CVODE workspace
+ */
+void SparseLinearSolver::Attach(void *cvode_mem)
+{
+    CVodeMem cv_mem = static_cast<CVodeMem>(cvode_mem);
+
+    if (cv_mem->cv_lfree != NULL) cv_mem->cv_lfree(cv_mem);
+
+    cv_mem->cv_linit  = &init;
+    cv_mem->cv_lsetup = &setup;
+    cv_mem->cv_lsolve = &solve;
+    cv_mem->cv_lfree  = &release;
+    cv_mem->cv_setupNonNull = TRUE;
+    cv_mem->cv_lmem = new SparseLinearSolver();
+}
+
+/*!
+ * @param[in]   cvode_mem   CVODE workspace
+ *
+ * @return      True if the sparse solver is attached
+ */
+bool SparseLinearSolver::IsAttached(const void *cvode_mem)
+{
+    return (cvode_mem != NULL) &&
+           (static_cast<const CVodeMemRec*>(cvode_mem)->cv_lsetup == &setup);
+}
+
+/*!
+ * @param[in]   cvode_mem   CVODE workspace
+ *
+ * @return      The attached sparse solver, or NULL for any other solver
+ */
+const SparseLinearSolver *SparseLinearSolver::Find(const void *cvode_mem)
+{
+    if (!IsAttached(cvode_mem)) return NULL;
+    return static_cast<const SparseLinearSolver*>(
+               static_cast<const CVodeMemRec*>(cvode_mem)->cv_lmem);
+}
+
+/*!
+ * The sparse solver is attached to the destination if it is not already.
+ *
+ * @param[in,out]   mem_dsc     Destination CVODE workspace
+ * @param[in]       mem_src     Source CVODE workspace, using the sparse solver
+ */
+void SparseLinearSolver::Copy(CVodeMemRec &mem_dsc, const CVodeMemRec &mem_src)
+{
+    if (!IsAttached(&mem_dsc)) Attach(&mem_dsc);
+    *static_cast<SparseLinearSolver*>(mem_dsc.cv_lmem) =
+        *static_cast<const SparseLinearSolver*>(mem_src.cv_lmem);
+}
+
+
+// CVODE LINEAR SOLVER INTERFACE.
+
+/*!
+ * @param[in,out]   cv_mem  CVODE workspace
+ *
+ * @return      Zero on success
+ */
+int SparseLinearSolver::init(CVodeMemRec *cv_mem)
+{
+    SparseLinearSolver &ls = *static_cast<SparseLinearSolver*>(cv_mem->cv_lmem);
+    ls.m_nstlj = 0;
+    ls.m_nje   = 0;
+    ls.m_nfact = 0;
+    ls.m_tfact = 0.0;
+    return 0;
+}
+
+/*!
+ * The Jacobian is re-evaluated on the same conditions as CVDense uses,
+ * and whenever the reactor mechanism has changed.
+ *
+ * @param[in,out]   cv_mem      CVODE workspace
+ * @param[in]       convfail    Reason for the call
+ * @param[in]       ypred       Predicted solution
+ * @param[in]       fpred       RHS at the predicted solution
+ * @param[out]      jcurPtr     Set if the Jacobian was re-evaluated
+ *
+ * @return      Zero on success, one if the matrix is singular
+ */
+int SparseLinearSolver::setup(CVodeMemRec *cv_mem, int convfail,
+                              N_Vector ypred, N_Vector fpred, booleantype *jcurPtr,
+                              N_Vector vtemp1, N_Vector vtemp2, N_Vector vtemp3)
+{
+    SparseLinearSolver &ls = *static_cast<SparseLinearSolver*>(cv_mem->cv_lmem);
+    ODE_Solver *s = static_cast<ODE_Solver*>(cv_mem->cv_user_data);
+    const Reactor &r = *s->GetReactor();
+
+    const double dgamma = std::fabs((cv_mem->cv_gamma / cv_mem->cv_gammap) - 1.0);
+    bool jbad = (cv_mem->cv_nst == 0) ||
+                (cv_mem->cv_nst > ls.m_nstlj + MaxStepsBetweenJac) ||
+                ((convfail == CV_FAIL_BAD_J) && (dgamma < MaxGammaChange)) ||
+                (convfail == CV_FAIL_OTHER);
+
+    // The symbolic analysis is only repeated for a new mechanism.
+    if (ls.m_mech != r.Mech()) {
+        std::vector<unsigned int> start, rows;
+        r.JacobianSparsity(start, rows);
+        ls.analyse(r.Mech(), start, rows);
+        jbad = true;
+    }
+
+    if (jbad) {
+        r.SparseJacobian(cv_mem->cv_tn, NV_DATA_S(ypred), ls.m_jac, cv_mem->cv_uround);
+        ls.m_nstlj = cv_mem->cv_nst;
+        ++ls.m_nje;
+        *jcurPtr = TRUE;
+    } else {
+        *jcurPtr = FALSE;
+    }
+
+    ls.assemble(cv_mem->cv_gamma);
+
+    const clock_t mark = clock();
+    const bool ok = ls.m_lu.Factorise(ls.m_values);
+    ls.m_tfact += (double)(clock() - mark) / (double)CLOCKS_PER_SEC;
+    ++ls.m_nfact;
+
+    return ok ? 0 : 1;
+}
+
+/*!
+ * @param[in,out]   cv_mem  CVODE workspace
+ * @param[in,out]   b       Right hand side on entry, solution on exit
+ *
+ * @return      Zero on success
+ */
+int SparseLinearSolver::solve(CVodeMemRec *cv_mem, N_Vector b, N_Vector weight,
+                              N_Vector ycur, N_Vector fcur)
+{
+    SparseLinearSolver &ls = *static_cast<SparseLinearSolver*>(cv_mem->cv_lmem);
+    const unsigned int n = ls.m_nsp;
+    double *const y = NV_DATA_S(b);
+
+    // Bordered right hand side: species, z, temperature, density.
+    fvector &rhs = ls.m_rhs;
+    for (unsigned int i=0; i!=n; ++i) rhs[i] = y[i];
+    rhs[n]   = 0.0;
+    rhs[n+1] = y[n];
+    rhs[n+2] = y[n+1];
+
+    ls.m_lu.Solve(&rhs[0]);
+
+    for (unsigned int i=0; i!=n; ++i) y[i] = rhs[i];
+    y[n]   = rhs[n+1];
+    y[n+1] = rhs[n+2];
+
+    // Scale the correction to account for a change in gamma since the
+    // last factorisation.
+    if ((cv_mem->cv_lmm == CV_BDF) && (cv_mem->cv_gamrat != 1.0)) {
+        N_VScale(2.0 / (1.0 + cv_mem->cv_gamrat), b, b);
+    }
+
+    return 0;
+}
+
+/*!
+ * @param[in,out]   cv_mem  CVODE workspace
+ */
+void SparseLinearSolver::release(CVodeMemRec *cv_mem)
+{
+    delete static_cast<SparseLinearSolver*>(cv_mem->cv_lmem);
+    cv_mem->cv_lmem = NULL;
+}
+
+
+// NEWTON MATRIX.
+
+/*!
+ * Each species row holds its entries of the species block followed by
+ * the z, temperature and density columns.  The z, temperature and
+ * density rows are dense in the species columns.
+ *
+ * @param[in]   mech    Mechanism whose pattern is given
+ * @param[in]   start   First entry of each species column, plus end
+ * @param[in]   rows    Row of each entry, sorted within each column
+ */
+void SparseLinearSolver::analyse(const Mechanism *mech,
+                                 const std::vector<unsigned int> &start,
+                                 const std::vector<unsigned int> &rows)
+{
+    const unsigned int n = start.size() - 1;
+    unsigned int i, k, p;
+
+    m_mech = mech;
+    m_nsp  = n;
+    m_jac.start = start;
+    m_jac.rows  = rows;
+
+    // Row starts.
+    m_start.assign(n + 4, 0);
+    for (p=0; p!=rows.size(); ++p) ++m_start[rows[p] + 1];
+    for (i=0; i!=n; ++i) m_start[i + 1] += 3;
+    m_start[n + 1] = n + 1;
+    m_start[n + 2] = n + 2;
+    m_start[n + 3] = n + 2;
+    for (i=0; i!=n + 3; ++i) m_start[i + 1] += m_start[i];
+
+    // Species block, transposed into rows.
+    m_cols.resize(m_start[n + 3]);
+    m_spmap.resize(rows.size());
+    std::vector<unsigned int> next(m_start.begin(), m_start.begin() + n);
+    for (k=0; k!=n; ++k) {
+        for (p=start[k]; p!=start[k + 1]; ++p) {
+            m_spmap[p] = next[rows[p]];
+            m_cols[next[rows[p]]++] = k;
+        }
+    }
+
+    // Border columns of the species rows.
+    for (i=0; i!=n; ++i) {
+        m_cols[next[i]]     = n;
+        m_cols[next[i] + 1] = n + 1;
+        m_cols[next[i] + 2] = n + 2;
+    }
+
+    // Border rows.
+    for (i=n; i!=n + 3; ++i) {
+        p = m_start[i];
+        for (k=0; k!=n; ++k) m_cols[p++] = k;
+        if (i == n) {
+            m_cols[p] = n;
+        } else {
+            m_cols[p]     = n + 1;
+            m_cols[p + 1] = n + 2;
+        }
+    }
+
+    m_values.assign(m_cols.size(), 0.0);
+    m_rhs.assign(n + 3, 0.0);
+    m_lu.Analyse(n + 3, m_start, m_cols, 3);
+}
+
+/*!
+ * @param[in]   gamma   Scaled step size of the Newton matrix I - gamma*J
+ */
+void SparseLinearSolver::assemble(double gamma)
+{
+    const unsigned int n = m_nsp;
+    const Sprog::Kinetics::SparseJacobian &J = m_jac;
+    unsigned int i, k, p;
+
+    // Species block.
+    for (k=0; k!=n; ++k) {
+        for (p=J.start[k]; p!=J.start[k + 1]; ++p) {
+            m_values[m_spmap[p]] = ((J.rows[p] == k) ? 1.0 : 0.0) - (gamma * J.values[p]);
+        }
+    }
+
+    // Border columns of the species rows.
+    for (i=0; i!=n; ++i) {
+        p = m_start[i + 1] - 3;
+        m_values[p]     = gamma * J.u[i];
+        m_values[p + 1] = - gamma * J.colT[i];
+        m_values[p + 2] = - gamma * J.colRho[i];
+    }
+
+    // Definition of z.
+    p = m_start[n];
+    for (k=0; k!=n; ++k) m_values[p + k] = - J.v[k];
+    m_values[p + n] = 1.0;
+
+    // Temperature row.
+    p = m_start[n + 1];
+    for (k=0; k!=n; ++k) m_values[p + k] = - gamma * J.rowT[k];
+    m_values[p + n]     = 1.0 - (gamma * J.colT[n]);
+    m_values[p + n + 1] = - gamma * J.colRho[n];
+
+    // Density row.
+    p = m_start[n + 2];
+    for (k=0; k!=n; ++k) m_values[p + k] = - gamma * J.rowRho[k];
+    m_values[p + n]     = - gamma * J.colT[n + 1];
+    m_values[p + n + 1] = 1.0 - (gamma * J.colRho[n + 1]);
+}
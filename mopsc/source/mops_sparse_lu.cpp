@@ -0,0 +1,323 @@
+ /*!
+  * @file   mops_sparse_lu.cpp
+  * @brief  Implementation of a sparse LU factorisation for the ODE solver
+  *
+  *   Licence:
+  *      mops is free software; you can redistribute it and/or
+  *      modify it under the terms of the GNU Lesser General Public License
+  *      as published by the Free Software Foundation; either version 2
+  *      of the License, or (at your option) any later version.
+  *
+  *      This program is distributed in the hope that it will be useful,
+  *      but WITHOUT ANY WARRANTY; without even the implied warranty of
+  *      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  *      GNU Lesser General Public License for more details.
+  *
+  *      You should have received a copy of the GNU Lesser General Public
+  *      License along with this program; if not, write to the Free Software
+  *      Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA
+  *      02111-1307, USA.
+  *
+  *   Contact:
+  *      Prof Markus Kraft
+  *      Dept of Chemical Engineering
+  *      University of Cambridge
+  *      New Museums Site
+  *      Pembroke Street
+  *      Cambridge
+  *      CB2 3RA, UK
+  *
+  *      Email:       mk306@cam.ac.uk
+  *      Website:     http://como.cheng.cam.ac.uk
+  */
+#include "mops_sparse_lu.h"
+
+#include <algorithm>
+#include <set>
+#include <stdexcept>
+#include <cmath>
+
+namespace Mops {
+
+// A pivot below this fraction of its row of U would let the entries of
+// later rows grow by more than its inverse, so the dense factors are used.
+const double SparseLU::PivotTolerance = 1.0e-6;
+
+//! Default constructor
+SparseLU::SparseLU()
+: m_n(0), m_use_dense(false), m_ndense(0)
+{}
+
+/*!
+ * @param[in]   n       Number of unknowns
+ * @param[in]   start   Start of each row in cols, plus end
+ * @param[in]   cols    Column of each entry; the rows need not be sorted
+ * @param[in]   nfixed  Number of trailing unknowns kept in place
+ *
+ * The diagonal is added to the factors if it is not in the pattern.
+ * The values passed to Factorise() must follow the order of cols.
+ */
+void SparseLU::Analyse(
+        unsigned int n,
+        const std::vector<unsigned int> &start,
+        const std::vector<unsigned int> &cols,
+        unsigned int nfixed)
+{
+    if ((start.size() != n + 1) || (nfixed > n))
+        throw std::invalid_argument("Inconsistent sparse matrix pattern "
+                "(Mops, SparseLU::Analyse).");
+
+    m_n = n;
+    m_pstart = start;
+    m_pcols = cols;
+    m_use_dense = false;
+    order(start, cols, nfixed);
+
+    // Symbolic factorisation.  Row i of the factors is the pattern of row
+    // i of the reordered matrix, together with the upper part of each row
+    // k < i that is eliminated from it.  The set is visited in increasing
+    // order, so fill added below the diagonal is eliminated in turn.
+    m_start.assign(1, 0);
+    m_col.clear();
+    m_diag.assign(n, 0);
+    for (unsigned int i = 0; i != n; ++i) {
+        const unsigned int r = m_perm[i];
+        std::set<unsigned int> row;
+        row.insert(i);
+        for (unsigned int p = start[r]; p != start[r + 1]; ++p)
+            row.insert(m_iperm[cols[p]]);
+
+        for (std::set<unsigned int>::iterator it = row.begin(); *it < i; ++it) {
+            const unsigned int k = *it;
+            for (unsigned int q = m_diag[k] + 1; q != m_start[k + 1]; ++q)
+                row.insert(m_col[q]);
+        }
+
+        for (std::set<unsigned int>::iterator it = row.begin(); it != row.end(); ++it) {
+            if (*it == i) m_diag[i] = m_col.size();
+            m_col.push_back(*it);
+        }
+        m_start.push_back(m_col.size());
+    }
+
+    // Position of each pattern entry in the factors.
+    m_map.resize(cols.size());
+    for (unsigned int r = 0; r != n; ++r) {
+        const unsigned int i = m_iperm[r];
+        for (unsigned int p = start[r]; p != start[r + 1]; ++p) {
+            m_map[p] = std::lower_bound(m_col.begin() + m_start[i],
+                                        m_col.begin() + m_start[i + 1],
+                                        m_iperm[cols[p]]) - m_col.begin();
+        }
+    }
+
+    m_lu.assign(m_col.size(), 0.0);
+    m_work.assign(n, 0.0);
+}
+
+/*!
+ * @param[in]   values  Matrix entries in the order of the analysed pattern
+ *
+ * @return      False if the matrix is singular
+ */
+bool SparseLU::Factorise(const fvector &values)
+{
+    m_use_dense = false;
+    std::fill(m_lu.begin(), m_lu.end(), 0.0);
+    for (unsigned int p = 0; p != m_map.size(); ++p)
+        m_lu[m_map[p]] += values[p];
+
+    fvector &w = m_work;
+    for (unsigned int i = 0; i != m_n; ++i) {
+        for (unsigned int p = m_start[i]; p != m_start[i + 1]; ++p)
+            w[m_col[p]] = m_lu[p];
+
+        // Eliminate the entries below the diagonal.
+        for (unsigned int p = m_start[i]; p != m_diag[i]; ++p) {
+            const unsigned int k = m_col[p];
+            const double l = w[k] / m_lu[m_diag[k]];
+            w[k] = l;
+            for (unsigned int q = m_diag[k] + 1; q != m_start[k + 1]; ++q)
+                w[m_col[q]] -= l * m_lu[q];
+        }
+
+        double umax = 0.0;
+        for (unsigned int p = m_start[i]; p != m_start[i + 1]; ++p) {
+            m_lu[p] = w[m_col[p]];
+            if (p >= m_diag[i]) umax = std::max(umax, std::fabs(m_lu[p]));
+        }
+        if (!(std::fabs(m_lu[m_diag[i]]) > PivotTolerance * umax)) {
+            ++m_ndense;
+            m_use_dense = true;
+            return factoriseDense(values);
+        }
+    }
+    return true;
+}
+
+/*!
+ * @param[in,out]   b   Right hand side on entry, solution on exit
+ */
+void SparseLU::Solve(double *b) const
+{
+    if (m_use_dense) {
+        solveDense(b);
+        return;
+    }
+
+    fvector &y = m_work;
+    for (unsigned int i = 0; i != m_n; ++i)
+        y[i] = b[m_perm[i]];
+
+    // Forward substitution with the unit lower factor.
+    for (unsigned int i = 0; i != m_n; ++i) {
+        double s = y[i];
+        for (unsigned int p = m_start[i]; p != m_diag[i]; ++p)
+            s -= m_lu[p] * y[m_col[p]];
+        y[i] = s;
+    }
+
+    // Backward substitution with the upper factor.
+    for (unsigned int i = m_n; i-- != 0; ) {
+        double s = y[i];
+        for (unsigned int p = m_diag[i] + 1; p != m_start[i + 1]; ++p)
+            s -= m_lu[p] * y[m_col[p]];
+        y[i] = s / m_lu[m_diag[i]];
+    }
+
+    for (unsigned int i = 0; i != m_n; ++i)
+        b[m_perm[i]] = y[i];
+}
+
+/*!
+ * Gaussian elimination with partial pivoting of the whole matrix, in the
+ * original order of the unknowns.  This costs O(n^3), as the dense solver
+ * of CVODE does, and is only used when the sparse factorisation meets a
+ * small pivot.
+ *
+ * @param[in]   values  Matrix entries in the order of the analysed pattern
+ *
+ * @return      False if a zero pivot was met
+ */
+bool SparseLU::factoriseDense(const fvector &values)
+{
+    const unsigned int n = m_n;
+    m_dense.assign(n * n, 0.0);
+    m_pivots.resize(n);
+    for (unsigned int r = 0; r != n; ++r) {
+        for (unsigned int p = m_pstart[r]; p != m_pstart[r + 1]; ++p)
+            m_dense[r * n + m_pcols[p]] += values[p];
+    }
+
+    double *a = &m_dense[0];
+    for (unsigned int k = 0; k != n; ++k) {
+        // Choose the largest entry of column k as the pivot.
+        unsigned int piv = k;
+        for (unsigned int r = k + 1; r != n; ++r) {
+            if (std::fabs(a[r * n + k]) > std::fabs(a[piv * n + k])) piv = r;
+        }
+        m_pivots[k] = piv;
+        if (a[piv * n + k] == 0.0) return false;
+        if (piv != k)
+            std::swap_ranges(a + k * n, a + (k + 1) * n, a + piv * n);
+
+        const double *const uk = a + k * n;
+        for (unsigned int r = k + 1; r != n; ++r) {
+            double *const ar = a + r * n;
+            if (ar[k] == 0.0) continue;
+            const double l = ar[k] / uk[k];
+            ar[k] = l;
+            for (unsigned int c = k + 1; c != n; ++c)
+                ar[c] -= l * uk[c];
+        }
+    }
+    return true;
+}
+
+/*!
+ * @param[in,out]   b   Right hand side on entry, solution on exit
+ */
+void SparseLU::solveDense(double *b) const
+{
+    const unsigned int n = m_n;
+    const double *const a = &m_dense[0];
+
+    // The whole rows were interchanged, so apply the interchanges first.
+    for (unsigned int k = 0; k != n; ++k)
+        std::swap(b[k], b[m_pivots[k]]);
+
+    // Forward substitution with the unit lower factor.
+    for (unsigned int i = 0; i != n; ++i) {
+        double s = b[i];
+        for (unsigned int c = 0; c != i; ++c)
+            s -= a[i * n + c] * b[c];
+        b[i] = s;
+    }
+
+    // Backward substitution.
+    for (unsigned int i = n; i-- != 0; ) {
+        double s = b[i];
+        for (unsigned int c = i + 1; c != n; ++c)
+            s -= a[i * n + c] * b[c];
+        b[i] = s / a[i * n + i];
+    }
+}
+
+/*!
+ * Greedy minimum degree ordering of the leading n - nfixed unknowns on
+ * the symmetrised pattern.  Eliminating an unknown joins its neighbours
+ * into a clique, which is the fill that its elimination would cause.
+ *
+ * @param[in]   start   Start of each row in cols, plus end
+ * @param[in]   cols    Column of each entry
+ * @param[in]   nfixed  Number of trailing unknowns kept in place
+ */
+void SparseLU::order(
+        const std::vector<unsigned int> &start,
+        const std::vector<unsigned int> &cols,
+        unsigned int nfixed)
+{
+    const unsigned int nfree = m_n - nfixed;
+
+    std::vector<std::set<unsigned int> > adj(nfree);
+    for (unsigned int r = 0; r != nfree; ++r) {
+        for (unsigned int p = start[r]; p != start[r + 1]; ++p) {
+            const unsigned int c = cols[p];
+            if ((c != r) && (c < nfree)) {
+                adj[r].insert(c);
+                adj[c].insert(r);
+            }
+        }
+    }
+
+    m_perm.clear();
+    std::vector<bool> done(nfree, false);
+    for (unsigned int step = 0; step != nfree; ++step) {
+        unsigned int best = nfree;
+        for (unsigned int r = 0; r != nfree; ++r) {
+            if (!done[r] && ((best == nfree) || (adj[r].size() < adj[best].size())))
+                best = r;
+        }
+
+        done[best] = true;
+        m_perm.push_back(best);
+
+        const std::set<unsigned int> nb(adj[best]);
+        for (std::set<unsigned int>::const_iterator a = nb.begin(); a != nb.end(); ++a) {
+            adj[*a].erase(best);
+            for (std::set<unsigned int>::const_iterator b = nb.begin(); b != nb.end(); ++b) {
+                if (*a != *b) adj[*a].insert(*b);
+            }
+        }
+        adj[best].clear();
+    }
+
+    for (unsigned int r = nfree; r != m_n; ++r)
+        m_perm.push_back(r);
+
+    m_iperm.resize(m_n);
+    for (unsigned int i = 0; i != m_n; ++i)
+        m_iperm[m_perm[i]] = i;
+}
+
+} // Mops namespace
@@ -45,6 +45,8 @@
 #include "string_functions.h"
 #include "csv_io.h"
 #include <stdexcept>
+#include <algorithm>
+#include <cmath>
 
 using namespace Mops;
 using namespace std;
@@ -53,12 +55,18 @@ using namespace Strings;
 // CONSTRUCTORS AND DESTRUCTORS.
 
 // Default constructor.
-StrangSolver::StrangSolver(void) {}
+StrangSolver::StrangSolver(void)
+: m_split_dt(0.0), m_nsplit_acc(0), m_nsplit_rej(0)
+{}
 
 // Copy constructor
 StrangSolver::StrangSolver(const StrangSolver &sol)
 : Mops::ParticleSolver(sol),
-  Sweep::Solver(sol) {}
+  Sweep::Solver(sol),
+  m_split_dt(sol.m_split_dt),
+  m_nsplit_acc(sol.m_nsplit_acc),
+  m_nsplit_rej(sol.m_nsplit_rej)
+{}
 
 //! Clone the object
 StrangSolver *const StrangSolver::Clone() const {
@@ -71,6 +79,38 @@ StrangSolver::~StrangSolver(void)
 }
 
 
+// SOLVER INITIALISATION AND RESET.
+
+/*!
+ * @param[in,out]   r   Reactor to solve
+ *
+ * The splitting step size and step counts are those of a new run, so a
+ * run gives the same results whether the solver is reset or cloned.
+ */
+void StrangSolver::Initialise(Reactor &r)
+{
+    ParticleSolver::Initialise(r);
+    resetSplitting();
+}
+
+/*!
+ * @param[in,out]   r   Reactor to solve
+ */
+void StrangSolver::Reset(Reactor &r)
+{
+    ParticleSolver::Reset(r);
+    resetSplitting();
+}
+
+// Forgets the adaptive splitting step size and zeroes the step counts.
+void StrangSolver::resetSplitting()
+{
+    m_split_dt   = 0.0;
+    m_nsplit_acc = 0;
+    m_nsplit_rej = 0;
+}
+
+
 // SOLVING REACTORS.
 
 // Solves the coupled reactor using a Strang splitting algorithm
@@ -84,6 +124,18 @@ void StrangSolver::Solve(Reactor &r, double tstop, int nsteps, int niter,
     // calculate total computation time.
     clock_t totmark = clock();
 
+    if (m_gas_change_tol > 0.0) {
+        adaptiveSolve(r, tstop, nsteps, rng);
+
+        // Calculate total computation time.
+        m_tottime += calcDeltaCT(totmark);
+
+        // Call the output function.
+        if (out) out(nsteps, niter, r, *this, data);
+        return;
+    }
+    m_nsplit_acc += nsteps;
+
     // Time counters.
     double t2 = r.Time();
     double dt = (tstop - t2) / (double)nsteps; // Step size.
@@ -122,7 +174,7 @@ void StrangSolver::Solve(Reactor &r, double tstop, int nsteps, int niter,
         m_cpu_mark = clock();
         // Solve whole step of gas-phase chemistry.
         rho = r.Mixture()->GasPhase().MassDensity();
-        m_ode.ResetSolver();
+        m_ode.RestartSolver();
         m_ode.Solve(r, t2+=dt);
         r.SetTime(t2);
         m_chemtime += calcDeltaCT(m_cpu_mark);
@@ -140,7 +192,7 @@ void StrangSolver::Solve(Reactor &r, double tstop, int nsteps, int niter,
     m_cpu_mark = clock();
     // Solve last half-step of gas-phase chemistry.  
     rho = r.Mixture()->GasPhase().MassDensity();
-    m_ode.ResetSolver();
+    m_ode.RestartSolver();
     m_ode.Solve(r, t2+=h);
     r.Mixture()->AdjustSampleVolume(rho / r.Mixture()->GasPhase().MassDensity());
     r.SetTime(t2);
@@ -154,8 +206,154 @@ void StrangSolver::Solve(Reactor &r, double tstop, int nsteps, int niter,
 }
 
 
+// COMPUTATION TIME.
+
+// Returns the number of CT time variables tracked by this
+// solver type.
+unsigned int StrangSolver::CT_Count(void) const
+{
+    return ParticleSolver::CT_Count() + 2;
+}
+
+// Outputs internal computation time data to the given
+// binary stream.  The splitting step counts are written as
+// doubles, like the times.
+void StrangSolver::OutputCT(std::ostream &out) const
+{
+    ParticleSolver::OutputCT(out);
+    double val = (double)m_nsplit_acc;
+    out.write((char*)&val, sizeof(val));
+    val = (double)m_nsplit_rej;
+    out.write((char*)&val, sizeof(val));
+}
+
+// Adds the CT descriptions to a vector of strings.
+void StrangSolver::CT_Names(vector<string> &names, unsigned int start) const
+{
+    // Resize output vector to hold names, and get iterator
+    // to first insertion point.
+    if (start+CT_Count() > names.size()) names.resize(start+CT_Count(), "");
+
+    // Get ParticleSolver names.
+    ParticleSolver::CT_Names(names, start);
+
+    // Add names to output array.
+    names[start+ParticleSolver::CT_Count()]   = "Accepted Splitting Steps";
+    names[start+ParticleSolver::CT_Count()+1] = "Rejected Splitting Steps";
+}
+
+
 // SOLUTION ROUTINES.
 
+// Solves the reactor up to the stop time with adaptive splitting
+// steps.  The first step is (tstop - t) / nsteps, later steps carry on
+// from the step size proposed at the end of the last call, and the last
+// step is shortened to land on the stop time.  A step is only rejected
+// before its population balance step, so rolling it back only needs the
+// gas-phase state.
+void StrangSolver::adaptiveSolve(Reactor &r, double tstop, int nsteps,
+                                 Sweep::rng_type &rng)
+{
+    // Step size limits, as fractions of the interval and of the
+    // current step.
+    const double hmin = 1.0e-6 * (tstop - r.Time());
+    const double facmin = 0.2, facmax = 2.0, safety = 0.9;
+
+    if (m_split_dt <= 0.0)
+        m_split_dt = (tstop - r.Time()) / (double)std::max(nsteps, 1);
+
+    // This function stores heat capacity and particle density for the step
+    storeTemperatureProperties(r, rng);
+
+    while (r.Time() < tstop) {
+        // Land exactly on the stop time.
+        double dt = m_split_dt;
+        const bool last = (r.Time() + (1.0 + 1.0e-6) * dt >= tstop);
+        if (last) dt = tstop - r.Time();
+
+        double err = 0.0;
+        const bool accepted = strangStep(dt, hmin, r, rng, err);
+
+        const double fac = std::min(facmax, std::max(facmin, safety / std::max(err, 1.0e-10)));
+        if (accepted) {
+            ++m_nsplit_acc;
+            if (last) r.SetTime(tstop);
+            // Do not let a shortened last step shrink the next one.
+            if (!last || (fac < 1.0)) m_split_dt = dt * fac;
+        } else {
+            ++m_nsplit_rej;
+            m_split_dt = std::max(dt * fac, hmin);
+        }
+    }
+}
+
+// Takes one symmetric splitting step: half a step of gas-phase
+// chemistry, a whole step of population balance and another half step
+// of chemistry.  The step size is controlled by limiting the change of
+// the gas phase over the step, taken as twice that over the first
+// half-step, relative to the gas-change tolerance.  This is not an
+// estimate of the splitting error: it ignores the feedback of the
+// particles on the gas phase and only keeps the population balance from
+// seeing a gas phase that changes a lot within one step.  The measure
+// only involves the deterministic chemistry and is taken before the
+// stochastic population balance step: accepting or rejecting steps on
+// the outcome of the particle events would bias the ensemble.  If the
+// change is above the limit and dt is above hmin, the gas phase is
+// restored and false is returned; otherwise the step is completed.
+bool StrangSolver::strangStep(double dt, double hmin, Reactor &r,
+                              Sweep::rng_type &rng, double &err)
+{
+    const unsigned int n = r.ODE_Count();
+    double *const y = r.Mixture()->GasPhase().RawData();
+    const double t0 = r.Time();
+    double t2 = t0;
+    double ts1 = t2, ts2 = t2;
+    unsigned int i;
+
+    m_y0.assign(y, y + n);
+
+    // Solve first half-step of gas-phase chemistry.
+    m_cpu_mark = clock();
+    double rho = r.Mixture()->GasPhase().MassDensity();
+    m_ode.RestartSolver();
+    m_ode.Solve(r, t2+=0.5*dt);
+    r.SetTime(t2);
+    m_chemtime += calcDeltaCT(m_cpu_mark);
+
+    double sum = 0.0;
+    for (i=0; i!=n; ++i) {
+        const double d = 2.0 * (y[i] - m_y0[i]) / ((m_gas_change_tol * std::fabs(m_y0[i])) + m_atol);
+        sum += d * d;
+    }
+    err = std::sqrt(sum / (double)n);
+
+    if ((err > 1.0) && (dt > hmin)) {
+        // Roll back the chemistry; the particles have not been touched.
+        std::copy(m_y0.begin(), m_y0.end(), y);
+        r.SetTime(t0);
+        m_ode.ResetSolver(r);
+        return false;
+    }
+
+    // Solve one whole step of population balance (Sweep).
+    m_cpu_mark = clock();
+    storeTemperatureProperties(r, rng);
+    r.Mixture()->AdjustSampleVolume(rho / r.Mixture()->GasPhase().MassDensity());
+    Run(ts1, ts2+=dt, *r.Mixture(), r.Mech()->ParticleMech(), rng);
+    m_swp_ctime += calcDeltaCT(m_cpu_mark);
+
+    // Solve last half-step of gas-phase chemistry.
+    m_cpu_mark = clock();
+    rho = r.Mixture()->GasPhase().MassDensity();
+    m_ode.RestartSolver();
+    m_ode.Solve(r, t2+=0.5*dt);
+    r.Mixture()->AdjustSampleVolume(rho / r.Mixture()->GasPhase().MassDensity());
+    r.SetTime(t2);
+    m_chemtime += calcDeltaCT(m_cpu_mark);
+
+    return true;
+}
+
 void StrangSolver::multiStrangStep(double dt, unsigned int n, Mops::Reactor &r,
                                    Sweep::rng_type &rng)
 {
@@ -190,7 +388,7 @@ void StrangSolver::multiStrangStep(double dt, unsigned int n, Mops::Reactor &r,
         m_cpu_mark = clock();
             // Solve whole step of gas-phase chemistry.
             rho = r.Mixture()->GasPhase().MassDensity();
-            m_ode.ResetSolver();
+            m_ode.RestartSolver();
             m_ode.Solve(r, t2+=dt);
             r.SetTime(t2);
         m_chemtime += calcDeltaCT(m_cpu_mark);
@@ -205,7 +403,7 @@ void StrangSolver::multiStrangStep(double dt, unsigned int n, Mops::Reactor &r,
 
     m_cpu_mark = clock();
         // Solve last half-step of gas-phase chemistry.    
-        m_ode.ResetSolver();
+        m_ode.RestartSolver();
         m_ode.Solve(r, t2+=h);
         r.SetTime(t2);
     m_chemtime += calcDeltaCT(m_cpu_mark);
@@ -0,0 +1,149 @@
+/*
+  Project:        mopsc (gas-phase chemistry solver).
+  Sourceforge:    http://sourceforge.net/projects/mopssuite
+
+  File purpose:
+    Stress test for evaluating the right-hand sides of several reactors
+    concurrently.  Each reactor is set up on its own copy of the
+    mechanism, as the runs of a parallel simulation are, and its RHS is
+    evaluated once serially for reference.  The RHS of all reactors are
+    then evaluated many times from an OpenMP loop, and every result must
+    be identical to the serial one.  Any state shared between reactors in
+    the RHS functions shows up as a mismatch.
+
+    Usage:
+        test_rhs_threads chem.inp therm.dat [reactors] [repeats]
+
+    for example with the aluminium case in the source tree:
+        test_rhs_threads aluminum/chem.inp aluminum/therm.dat 32 500
+
+    The driver is linked against mopsc, sweepc and sprogc and compiled
+    with OpenMP.  It returns 0 if all results match, 1 if any does not
+    and 2 on bad input.
+
+  Licence:
+    This file is part of "mops".
+
+    mops is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+  Contact:
+    Dr Markus Kraft
+    Dept of Chemical Engineering
+    University of Cambridge
+    New Museums Site
+    Pembroke Street
+    Cambridge
+    CB2 3RA
+    UK
+
+    Email:       mk306@cam.ac.uk
+    Website:     http://como.cheng.cam.ac.uk
+*/
+
+#include "mops_mechanism.h"
+#include "mops_reactor.h"
+#include "mops_mixture.h"
+#include "gpc_mech_io.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+using namespace Mops;
+
+// Evaluates the RHS of the energy model the reactor uses.
+static void rhs(const Reactor &r, const fvector &y, fvector &ydot)
+{
+    if (r.EnergyEquation() == Reactor::ConstT) {
+        r.RHS_ConstT(0.0, &y[0], &ydot[0]);
+    } else {
+        r.RHS_Adiabatic(0.0, &y[0], &ydot[0]);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc < 3) {
+        std::cerr << "Usage: test_rhs_threads chem.inp therm.dat [reactors] [repeats]"
+                  << std::endl;
+        return 2;
+    }
+    const int n = (argc > 3) ? atoi(argv[3]) : 16;
+    const int repeats = (argc > 4) ? atoi(argv[4]) : 200;
+    if ((n <= 0) || (repeats <= 0)) {
+        std::cerr << "The reactor and repeat counts must be positive." << std::endl;
+        return 2;
+    }
+
+    std::vector<Mechanism*> mechs(n, (Mechanism*)NULL);
+    std::vector<Reactor*> reactors(n, (Reactor*)NULL);
+    std::vector<fvector> y(n), ref(n);
+    int bad = 0;
+
+    try {
+        Mechanism mech;
+        Sprog::IO::MechanismParser::ReadChemkin(argv[1], mech.GasMech(), argv[2]);
+        mech.ParticleMech().SetSpecies(mech.GasMech().Species());
+
+        // Set up the reactors at different temperatures, alternating
+        // between the two energy models, and get the serial results.
+        for (int i=0; i!=n; ++i) {
+            mechs[i] = new Mechanism(mech);
+            reactors[i] = new Reactor(*mechs[i]);
+
+            Mops::Mixture *mix = new Mops::Mixture(mechs[i]->ParticleMech());
+            mix->GasPhase().SetTemperature(1200.0 + 25.0 * i);
+            mix->GasPhase().SetPressure(1.0e5);
+            mix->GasPhase().SetFracs(fvector(mechs[i]->GasMech().SpeciesCount(), 1.0));
+            mix->GasPhase().Normalise();
+            reactors[i]->Fill(*mix);
+            reactors[i]->SetConstP();
+            reactors[i]->SetEnergyEquation((i % 2 == 0) ? Reactor::ConstT : Reactor::Adiabatic);
+
+            const double *const data = reactors[i]->Mixture()->GasPhase().RawData();
+            y[i].assign(data, data + reactors[i]->ODE_Count());
+            ref[i].assign(y[i].size(), 0.0);
+            rhs(*reactors[i], y[i], ref[i]);
+        }
+
+        // Evaluate all reactors concurrently.  A reactor is only used by
+        // one thread at a time, as in a parallel simulation.
+#pragma omp parallel for schedule(dynamic, 1) reduction(+:bad)
+        for (int i=0; i<n; ++i) {
+            fvector ydot(ref[i].size(), 0.0);
+            for (int k=0; k!=repeats; ++k) {
+                std::fill(ydot.begin(), ydot.end(), 0.0);
+                rhs(*reactors[i], y[i], ydot);
+                if (ydot != ref[i]) ++bad;
+            }
+        }
+    } catch (std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        bad = -1;
+    }
+
+    for (int i=0; i!=n; ++i) {
+        delete reactors[i];
+        delete mechs[i];
+    }
+
+    if (bad < 0) return 2;
+    std::cout << bad << " of " << n * repeats
+              << " concurrent RHS evaluations differ from the serial results."
+              << std::endl;
+    return (bad == 0) ? 0 : 1;
+}
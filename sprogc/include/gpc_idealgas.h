@@ -376,16 +376,35 @@ protected:
     IdealGas(void);
 
 private:
-    // Calculates a polynomial fit of any thermo property given the
-    // temperature terms.  The polynomial coefficients are found per
-    // species.
-    void sumTerms(
-        double T,     // Temperature (K).
-        double *t,    // Temperature terms in polynomial.
-        int n,      // Number of terms in polynomial.
-        fvector &Xs // Output vector for all species.
-        ) const;
+    // PACKED THERMO POLYNOMIALS.
+
+    // Packs the thermo fitting parameters of the species into
+    // contiguous arrays, if the species list has changed.
+    void packThermo(void) const;
+
+    // Evaluates Cp/R, H/RT and S/R of all species at the given
+    // temperature, unless it was the temperature of the last call.
+    void evalThermo(double T) const;
+
+    // Species list which has been packed, and its size.
+    mutable const SpeciesPtrVector *m_th_species;
+    mutable unsigned int m_th_nsp;
+
+    // Largest number of thermo ranges of any species.
+    mutable unsigned int m_th_nrange;
+
+    // Upper temperature of each range but the last [range][species].
+    mutable fvector m_th_tmax;
+
+    // Fitting parameters [range][parameter][species].
+    mutable fvector m_th_coef;
+
+    // Parameters valid at the last temperature [parameter][species].
+    mutable fvector m_th_active;
 
+    // Last temperature, and Cp/R, H/RT and S/R at that temperature.
+    mutable double m_th_T;
+    mutable fvector m_th_cp, m_th_h, m_th_s;
 
 };
 };
@@ -267,6 +267,10 @@ public:
     // Returns a pointer to the ith reaction. Returns NULL if i is invalid.
     Kinetics::Reaction * GetReactions(unsigned int i);
 
+    // Rebuilds the reaction set rate data.  This must be called after
+    // reactions have been modified through GetReactions().
+    void UpdateReactions(void);
+
     // Adds an empty reaction to the mechanism.
     Kinetics::Reaction *const AddReaction(void);
 
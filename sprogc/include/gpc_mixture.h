@@ -80,7 +80,7 @@ public:
 
     //! Set viscosity model
     void SetViscosityModel(Sprog::ViscosityModel vmodel)
-        {m_vmodel = vmodel;}
+        {m_vmodel = vmodel; clearTransportCache();}
 
     //! Get viscosity model
     Sprog::ViscosityModel GetViscosityModel(void) const
@@ -295,6 +295,15 @@ public:
     // returns the vector of mixture diffusion coefficient in m^2/s.
     const std::vector<double> getMixtureDiffusionCoeff(const double pre)const;
 
+    //! Number of viscosity and conductivity requests served from the cache
+    unsigned long TransportCacheHits() const;
+
+    //! Number of viscosity and conductivity requests that were calculated
+    unsigned long TransportCacheMisses() const;
+
+    //! Zero the transport cache hit and miss counters
+    void ResetTransportCacheStats();
+
     //! Index of temperature in m_data
     size_t temperatureIndex() const {return m_species->size();}
 
@@ -367,6 +376,21 @@ private:
     //! The viscosity model used
     Sprog::ViscosityModel m_vmodel;
 
+    //! Transport property cache, defined in gpc_mixture.cpp
+    struct TransportCache;
+
+    //! Transport property cache owned by this mixture, not part of its state
+    TransportCache *m_tc;
+
+    //! True if the cache key matches the current mixture state
+    bool transportStateMatches() const;
+
+    //! Set the cache key to the current state and discard all values
+    void resetTransportCache() const;
+
+    //! Discard the cache key and all values
+    void clearTransportCache() const;
+
 };
 } //namespace Thermo
 } //namespace Sprog
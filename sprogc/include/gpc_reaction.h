@@ -218,6 +218,23 @@ public:
     // Sets the reverse Arrhenius parameters.
     void SetRevArrhenius(const ARRHENIUS &arr);
 
+
+    // TEMPERATURE RANGE.
+
+    // Returns true if the reaction is only active over a limited
+    // temperature range.
+    bool HasTemperatureRange(void) const;
+
+    // Returns the lowest temperature at which the reaction is active.
+    double MinTemperature(void) const;
+
+    // Returns the temperature from which the reaction is inactive.
+    double MaxTemperature(void) const;
+
+    // Sets the temperature range [tmin, tmax) outside which the forward
+    // rate constant is zero (and so the equilibrium reverse rate).
+    void SetTemperatureRange(double tmin, double tmax);
+
 	
 	// FORD
 	// Returns true if this reaction uses ford.
@@ -422,7 +439,8 @@ public:
         ar & m_name & m_reversible
            & m_reac & m_prod & m_dstoich & m_dreac & m_dprod
            & m_arrf & m_arrr & m_lt & m_revlt & m_fo & m_covr & m_usetb
-	   & m_thirdbodies & m_fotype & m_foparams & m_isSurface & m_sticking & m_mottwise & m_isCoverage & m_coverage & m_isFord & m_ford & m_mech & m_deltaStoich & m_phaseVector;
+	   & m_thirdbodies & m_fotype & m_foparams & m_isSurface & m_sticking & m_mottwise & m_isCoverage & m_coverage & m_isFord & m_ford & m_mech & m_deltaStoich & m_phaseVector
+           & m_tmin & m_tmax;
     }
 
     // Writes the element to a binary data stream.
@@ -455,6 +473,7 @@ protected:
     double m_dstoich, m_dreac, m_dprod;      // Total stoichiometry changes.
     ARRHENIUS m_arrf, *m_arrr;             // Forward and reverse Arrhenius parameters.
     LTCOEFFS *m_lt, *m_revlt;              // Landau-Teller forward and reverse coefficients.
+    double m_tmin, m_tmax;                 // Temperature range over which the reaction is active.
     COVERAGE m_covr; // for Deserialisation and Serialisation 
 
     FORD m_fo; // for Deserialisation and Serialisation     
@@ -45,6 +45,7 @@
 #include "gpc_stoich.h"
 #include <vector>
 #include <string>
+#include <limits>
 
 class Reaction; // Forward declaration of Reaction class.
 
@@ -76,6 +77,14 @@ inline const ARRHENIUS &Reaction::Arrhenius() const {return m_arrf;};
 // for explicit reverse parameters.
 inline const ARRHENIUS *const Reaction::RevArrhenius(void) const {return m_arrr;};
 
+// TEMPERATURE RANGE.
+inline bool Reaction::HasTemperatureRange() const
+{
+    return (m_tmin > 0.0) || (m_tmax < std::numeric_limits<double>::max());
+};
+inline double Reaction::MinTemperature() const {return m_tmin;};
+inline double Reaction::MaxTemperature() const {return m_tmax;};
+
 
 // SURFACE REACTION
 inline bool Reaction::IsSURF() const {return m_isSurface;}; 
@@ -57,6 +57,26 @@ class Mechanism; // Forward declare Mechanism class.
 
 namespace Kinetics
 {
+// Analytic Jacobian of a homogeneous mixture in bordered sparse form,
+// for the variables (x, T, density).  The species block is
+//     dF_i/dx_k = values(i,k) - u_i * v_k,
+// where values is held in compressed column form on the pattern given
+// by ReactionSet::JacobianSparsity.  The outer product u v^T couples all
+// species through the total molar production rate, so it is held
+// separately to keep the block sparse.  The temperature and density
+// columns are held in full, and their rows over the species columns.
+struct SparseJacobian
+{
+    std::vector<unsigned int> start; // First entry of each species column, plus end.
+    std::vector<unsigned int> rows;  // Row of each entry, sorted within each column.
+    fvector values; // Entries of the species block.
+    fvector u, v;   // Outer product subtracted from the species block.
+    fvector colT;   // Temperature column, all NSP+2 rows.
+    fvector colRho; // Density column, all NSP+2 rows.
+    fvector rowT;   // Temperature row, species columns.
+    fvector rowRho; // Density row, species columns.
+};
+
 //! Calculates reaction data
 class ReactionSet
 {
@@ -90,6 +110,10 @@ public:
     // Adds a reaction to the set.
     Reaction *const AddReaction(const Reaction &rxn);
 
+    // Rebuilds the packed rate data.  This must be called after reactions
+    // in the set have been modified in place.
+    void Update(void);
+
 
     // TIDYING UP.
 
@@ -257,6 +281,11 @@ public:
 
     // JACOBIAN EVALUATION.
 
+    // Returns true if CalcJacobian evaluates the species and density
+    // columns analytically.  Mechanisms with surface, FORD or coverage
+    // reactions are finite differenced.
+    bool HasAnalyticJacobian(void) const;
+
     // Calculates the Jacobian matrix for a constant volume, adiabatic
     // homogeneous mixture. J[j][i] is the Jacobian entry for variable
     // i with respect to i: dFi/dYj.  It is assumed that the Jacobian
@@ -274,6 +303,30 @@ public:
         bool constT=false // Is system constant temperature or adiabatic?
         ) const;
 
+    // Returns the sparsity pattern of the species block of the analytic
+    // Jacobian in compressed column form.  Column k holds the rows
+    // rows[start[k]] to rows[start[k+1]-1] in increasing order, and always
+    // includes the diagonal.
+    void JacobianSparsity(
+        std::vector<unsigned int> &start, // Return vector for the column starts, plus end.
+        std::vector<unsigned int> &rows   // Return vector for the rows of each entry.
+        ) const;
+
+    // Calculates the analytic Jacobian in bordered sparse form.  The
+    // start and rows members of J must hold the pattern returned by
+    // JacobianSparsity.  Only valid if HasAnalyticJacobian() is true.
+    void CalcSparseJacobian(
+        double T,           // The mixture temperature.
+        double density,     // Mixture molar density.
+        double *const x,    // Species mole fractions.
+        unsigned int n,   // Number of values in x array.
+        const Sprog::Thermo::ThermoInterface &thermo, // Thermodynamics interface.
+        double pfac,        // Perturbation factor for the temperature column.
+        SparseJacobian &J,  // Sparse Jacobian.
+        bool constV=true, // Is system constant volume or constant pressure?
+        bool constT=false // Is system constant temperature or adiabatic?
+        ) const;
+
 //! Calculates domegai/dcj as opposed to above which calculates d(dxi/dt)/dxj
     void RateJacobian(
         double T,           // The mixture temperature.
@@ -308,6 +361,7 @@ public:
         ar & m_rxns & m_rev_rxns
            & m_tb_rxns & m_fo_rxns
            & m_lt_rxns & m_revlt_rxns & m_surface_rxns & m_ford_rxns & m_cov_rxns & m_stick_rxns & m_mottw_rxns & m_mech;
+        pack();
     }
 
     // Writes the element to a binary data stream.
@@ -349,7 +403,9 @@ protected:
     // Calculates the pressure-dependent fall-off terms in the rate
     // constant expressions.  This function multiplies the rate constants
     // by the fall-off terms.  This function may also change the values in
-    // the tbconcs vector.
+    // the tbconcs vector.  If dlnk is given then d(ln k)/d(ln M) of each
+    // fall-off reaction is also returned in it, where M is the third-body
+    // concentration used in the reduced pressure.
     void calcFallOffTerms(
         double T,              // The mixture temperature.
         double density,        // Mixture molar density.
@@ -357,7 +413,112 @@ protected:
         unsigned int n,      // Number of values in x array.
         fvector &tbconcs,    // Vector of third-body concentrations (alterable).
         fvector &kf,         // Return vector for forward rate constants.
-        fvector &kr          // Return vector for reverse rate constants.
+        fvector &kr,         // Return vector for reverse rate constants.
+        fvector *dlnk=NULL   // Optional return vector for fall-off log-derivatives.
+        ) const;
+
+    // Returns the fall-off factor of the fth packed fall-off reaction, by
+    // which its rate constants are multiplied.  tbconc is set to 1.0 if
+    // the enhanced third-body concentration is used in the reduced pressure.
+    double calcFallOffFactor(
+        unsigned int f,        // Index of the reaction in the packed fall-off arrays.
+        double T,              // The mixture temperature.
+        double invRT,          // 1 / RT in the units of the mechanism.
+        double density,        // Mixture molar density.
+        const double *const x, // Species mole fractions.
+        double kf,             // High pressure forward rate constant.
+        double &tbconc,        // Third-body concentration (alterable).
+        double *dlnk           // Optional return value for the log-derivative.
+        ) const;
+
+    // Returns 1 / RT in the units of the mechanism.
+    double calcInvRT(double T) const;
+
+    // Finds, for each species, the reactions whose third-body concentration
+    // or fall-off reduced pressure depend on its mole fraction.  The
+    // reactions of species k are rxns[start[k]] to rxns[start[k+1]-1].
+    void thirdBodyDependents(
+        std::vector<unsigned int> &start, // Return vector for the start of each species.
+        std::vector<unsigned int> &rxns   // Return vector for the reactions.
+        ) const;
+
+    // Recalculates the rates of progress of the reactions which depend on
+    // the mole fraction of species k, after it has been perturbed, and adds
+    // the resulting changes in the molar production rates to wdot.  Only
+    // the reactions of species k in the stoichiometry cross-reference and
+    // in the third-body dependents are evaluated.  Returns the change in
+    // the total molar production rate.
+    double calcPerturbedRates(
+        unsigned int k,        // Perturbed species.
+        double T,              // The mixture temperature.
+        double density,        // Mixture molar density.
+        const double *const x, // Perturbed species mole fractions.
+        unsigned int n,        // Number of values in x array.
+        const fvector &kfT,    // Concentration-independent forward rate constants.
+        const fvector &krT,    // Concentration-independent reverse rate constants.
+        const fvector &rop0,   // Unperturbed rates of progress.
+        const std::vector<unsigned int> &tbstart, // Third-body dependents
+        const std::vector<unsigned int> &tbrxns,  //   from thirdBodyDependents().
+        std::vector<unsigned int> &mark, // Workspace, one value per reaction.
+        fvector &wdot          // Molar production rates to update.
+        ) const;
+
+
+    // Calculates the Jacobian matrix with the species and density columns
+    // found analytically and the temperature column by finite difference.
+    void calcJacobianAnalytic(
+        double T,           // The mixture temperature.
+        double density,     // Mixture molar density.
+        double *const x,    // Species mole fractions.
+        unsigned int n,   // Number of values in x array.
+        const Sprog::Thermo::ThermoInterface &thermo, // Thermodynamics interface.
+        double pfac,        // Perturbation factor for the temperature column.
+        double **J,         // Jacobian matrix array.
+        bool constV,      // Is system constant volume or constant pressure?
+        bool constT       // Is system constant temperature or adiabatic?
+        ) const;
+
+    // Calculates the rates of progress and their derivatives used by the
+    // analytic Jacobians, leaving them in the workspace.  Returns the total
+    // molar production rate.
+    double calcJacobianTerms(
+        double T,              // The mixture temperature.
+        double density,        // Mixture molar density.
+        const double *const x, // Species mole fractions.
+        unsigned int n,      // Number of values in x array.
+        const Sprog::Thermo::ThermoInterface &thermo, // Thermodynamics interface.
+        bool constV,         // Is system constant volume or constant pressure?
+        bool constT,         // Is system constant temperature or adiabatic?
+        double &Tdot,        // Return value for dT/dt.
+        double &C            // Return value for the bulk heat capacity.
+        ) const;
+
+    // Calculates the temperature column of the Jacobian by finite difference.
+    void calcJacobianTColumn(
+        double T,              // The mixture temperature.
+        double density,        // Mixture molar density.
+        const double *const x, // Species mole fractions.
+        unsigned int n,      // Number of values in x array.
+        const Sprog::Thermo::ThermoInterface &thermo, // Thermodynamics interface.
+        double pfac,         // Perturbation factor.
+        bool constV,         // Is system constant volume or constant pressure?
+        bool constT,         // Is system constant temperature or adiabatic?
+        double wtot,         // Unperturbed total molar production rate.
+        double Tdot,         // Unperturbed dT/dt.
+        double *col          // Return array for the NSP+2 column entries.
+        ) const;
+
+    // Calculates the Jacobian matrix entirely by finite differences.
+    void calcJacobianFD(
+        double T,           // The mixture temperature.
+        double density,     // Mixture molar density.
+        double *const x,    // Species mole fractions.
+        unsigned int n,   // Number of values in x array.
+        const Sprog::Thermo::ThermoInterface &thermo, // Thermodynamics interface.
+        double pfac,        // Perturbation factor for calculating J entries.
+        double **J,         // Jacobian matrix array.
+        bool constV,      // Is system constant volume or constant pressure?
+        bool constT       // Is system constant temperature or adiabatic?
         ) const;
 
 
@@ -385,6 +546,145 @@ private:
 
     // Pointer to mechanism to which this ReactionSet belongs.
     Sprog::Mechanism *m_mech;
+
+    // Packed concentration products for one side of the gas-phase reactions.
+    // Each reaction is stored as a list of species indices, with a species
+    // of stoichiometry mu appearing mu times, so the rate of progress is the
+    // rate constant times the product of the listed concentrations.  Reactions
+    // with one, two and three factors are kept in separate arrays so that
+    // they are evaluated in loops of fixed length without touching the
+    // Reaction objects; higher orders use a compressed row layout.
+    struct PackedSide {
+        RxnMap rxns1, rxns2, rxns3;             // Reactions with 1, 2 and 3 factors.
+        std::vector<unsigned int> sp1, sp2, sp3; // Their species, 1, 2 and 3 per reaction.
+        RxnMap rxnsn;                           // Reactions with more than 3 factors.
+        std::vector<unsigned int> startn;       // Start of each reaction in spn, plus end.
+        std::vector<unsigned int> spn;          // Their species.
+
+        // Removes all reactions.
+        void Clear(void);
+
+        // Adds reaction i with the given factor species.
+        void Add(unsigned int i, const std::vector<unsigned int> &sp);
+
+        // Multiplies each packed r[i] by its concentration product.
+        void Multiply(const fvector &c, fvector &r) const;
+    };
+
+    PackedSide m_packed_fwd; // Forward (reactant) products.
+    PackedSide m_packed_rev; // Reverse (product) products.
+
+    // Forward Arrhenius parameters of all reactions, held in contiguous
+    // arrays so that the rate constants are evaluated in plain loops.
+    fvector m_arr_A, m_arr_n, m_arr_E;
+
+    // Explicit reverse Arrhenius parameters, in the order of m_rev_rxns.
+    fvector m_revarr_A, m_revarr_n, m_revarr_E;
+
+    // Reactions whose reverse rates are found by equilibrium.
+    RxnMap m_eq_rxns;
+
+    // Reactions which are only active over a limited temperature range,
+    // and the limits [min, max) of those ranges.
+    RxnMap m_trange_rxns;
+    fvector m_trange_min, m_trange_max;
+
+    // Third-body efficiencies of all reactions, as a sparse matrix in
+    // compressed row form with one row per reaction.  The enhanced
+    // third-body concentration of a reaction is density times one plus
+    // the product of its row with the mole fractions.  Species with unit
+    // efficiency are not stored.
+    std::vector<unsigned int> m_tb_start; // Start of each row, plus end.
+    std::vector<unsigned int> m_tb_sp;    // Species of each entry.
+    fvector m_tb_coeff;                   // Efficiency minus one of each entry.
+    std::vector<bool> m_tb_use;           // Does the reaction use a third body?
+
+    // Fall-off reactions and their parameters, in reaction order.  The
+    // broadening parameters are held MAX_FALLOFF_PARAMS per reaction.
+    RxnMap m_fo_index;                    // Reaction index.
+    std::vector<FALLOFF_FORM> m_fo_type;  // Fall-off form.
+    fvector m_fo_A, m_fo_n, m_fo_E;       // Low pressure limit.
+    std::vector<int> m_fo_tb;             // Third body species, or -1 for all.
+    fvector m_fo_params;                  // Broadening parameters.
+    std::vector<int> m_fo_pos;            // Position of each reaction in the fall-off
+                                          // arrays, or -1 if not fall-off.
+
+    // Rebuilds all packed rate data.
+    void pack(void);
+
+    // Adds reaction i to the packed concentration products.
+    void packReaction(unsigned int i);
+
+    // Adds reaction i to the packed Arrhenius and temperature range data.
+    void packArrhenius(unsigned int i);
+
+    // Adds reaction i to the packed third-body and fall-off data.
+    void packThirdBodies(unsigned int i);
+
+    // Clears the packed third-body and fall-off data.
+    void clearThirdBodies(void);
+
+    // Sparse structure of the analytic Jacobian.  Each gas-phase reaction
+    // has one slot for every species on which its rate of progress
+    // depends: the reactants, products, enhanced third bodies and the
+    // fall-off third body.  The derivatives of the rates of progress are
+    // held against these slots and scattered into the species rows through
+    // the stoichiometry cross-reference of the mechanism, so the work is
+    // proportional to the number of non-zeros rather than NSP^2.
+    struct JacobianPattern {
+        std::vector<unsigned int> start;   // First slot of each reaction, plus end.
+        std::vector<unsigned int> sp;      // Species of each slot.
+        std::vector<unsigned int> fstart;  // First forward factor of each reaction, plus end.
+        std::vector<unsigned int> fslot;   // Slot of each forward factor.
+        std::vector<unsigned int> rstart;  // First reverse factor of each reaction, plus end.
+        std::vector<unsigned int> rslot;   // Slot of each reverse factor.
+        std::vector<unsigned int> tbstart; // First enhanced third body of each reaction, plus end.
+        std::vector<unsigned int> tbslot;  // Slot of each enhanced third body.
+        fvector tbcoeff;                   // Enhancement minus one of each third body.
+        std::vector<bool> usetb;           // Does the reaction use a third body?
+        std::vector<int> foslot;           // Fall-off third body: -2 if not fall-off, -1
+                                           // if all species, otherwise the slot.
+        fvector dnu;                       // Net change in moles of each reaction.
+
+        // Removes all reactions.
+        void Clear(void);
+
+        // Returns the slot of species k in the last reaction, adding one
+        // if required.
+        unsigned int Slot(unsigned int k);
+    };
+
+    JacobianPattern m_jac;
+
+    // Adds reaction i to the Jacobian pattern.
+    void packJacobian(unsigned int i);
+
+    // Temporary vectors used by the rate calculation overloads which do not
+    // return all their intermediate results.  These were previously function
+    // statics, which made the rate routines unsafe to call from more than one
+    // thread even on different mechanisms.  They are mutable as their contents
+    // are not part of the state of the ReactionSet, and they are not copied.
+    mutable fvector m_wk_rop;     // Rates of progress.
+    mutable fvector m_wk_rfwd;    // Forward rates of progress.
+    mutable fvector m_wk_rrev;    // Reverse rates of progress.
+    mutable fvector m_wk_kf;      // Forward rate constants.
+    mutable fvector m_wk_kr;      // Reverse rate constants.
+    mutable fvector m_wk_Gs;      // Species Gibbs free energies (G/RT).
+    mutable fvector m_wk_tbconcs; // Third-body concentrations.
+    mutable fvector m_wk_conc;    // Species concentrations.
+
+    // Workspace for the analytic Jacobian.
+    mutable fvector m_wk_jac_drop;    // Rate of progress derivatives for each slot.
+    mutable fvector m_wk_jac_droprho; // Rate of progress derivatives w.r.t. density.
+    mutable fvector m_wk_jac_dlnk;    // Fall-off log-derivatives.
+    mutable fvector m_wk_jac_M;       // Third-body concentrations before fall-off.
+    mutable fvector m_wk_jac_dH;      // Enthalpy change of each reaction.
+    mutable fvector m_wk_jac_dwtot;   // Derivatives of the total production rate.
+    mutable fvector m_wk_jac_dS;      // Derivatives of sum(wdot * H).
+    mutable fvector m_wk_jac_wdot;    // Molar production rates.
+    mutable fvector m_wk_jac_xdot;    // Mole fraction derivatives.
+    mutable fvector m_wk_jac_Hs;      // Species enthalpies (or energies).
+    mutable fvector m_wk_jac_Cs;      // Species heat capacities.
 };
 }
 }
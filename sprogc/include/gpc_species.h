@@ -171,6 +171,10 @@ public:
     // Returns the set of thermo parameters valid for the given temperature.
     const Sprog::Thermo::THERMO_PARAMS &ThermoParams(const double T) const;
 
+    // Returns the thermo parameters of all ranges, keyed by the maximum
+    // temperature of each range.
+    const Sprog::Thermo::ThermoMap &ThermoParamsMap(void) const;
+
     // Adds a set of thermo parameters with the given end point temperature.
     void AddThermoParams(
         const double T, // Maximum temperature for which parameters are valid.
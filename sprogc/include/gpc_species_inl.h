@@ -63,6 +63,7 @@ inline double Species::MolWt() const {return m_molwt;};
 // THERMODYNAMIC FITTING PARAMETERS.
 inline unsigned int Species::ThermoRangeCount(void) const {return m_thermoparams.size();};
 inline void Species::SetThermoStartTemperature(const double T) {m_T1 = T;};
+inline const Sprog::Thermo::ThermoMap &Species::ThermoParamsMap(void) const {return m_thermoparams;};
 
 // PARENT MECHANISM.
 inline const Sprog::Mechanism *const Species::Mechanism(void) const {return m_mech;};
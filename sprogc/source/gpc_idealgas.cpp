@@ -53,22 +53,26 @@ using namespace std;
 
 // Default constructor (private).
 IdealGas::IdealGas(void)
+: m_th_species(NULL), m_th_nsp(0), m_th_nrange(0), m_th_T(-1.0)
 {
 }
 
 // Default constructor (public, requires species vector).
-IdealGas::IdealGas(const SpeciesPtrVector &sp) : GasPhase(sp)
+IdealGas::IdealGas(const SpeciesPtrVector &sp)
+: GasPhase(sp), m_th_species(NULL), m_th_nsp(0), m_th_nrange(0), m_th_T(-1.0)
 {
 }
 
 // Copy constructor.
 IdealGas::IdealGas(const Sprog::Thermo::IdealGas &copy)
+: m_th_species(NULL), m_th_nsp(0), m_th_nrange(0), m_th_T(-1.0)
 {
     *this = copy;
 }
 
 // Stream-reading constructor.
 IdealGas::IdealGas(std::istream &in, const SpeciesPtrVector &sp)
+: m_th_species(NULL), m_th_nsp(0), m_th_nrange(0), m_th_T(-1.0)
 {
     //Deserialize(in);
     SetSpecies(sp);
@@ -211,43 +215,19 @@ double IdealGas::CalcBulkU_RT(double T,
 // Calculates enthalpies of all species.
 void IdealGas::CalcHs(double T, fvector &H) const
 {
-    int i, n;
-    double t[Thermo::H_PARAM_COUNT];
-
-    // Ensure output array has sufficient length.
-    H.resize(Species()->size());
-
-    // Precalculate temperature terms.
-    t[0] = R * T;
-    n = Thermo::H_PARAM_COUNT;
-    for (i=1; i<n-1; i++) {
-        t[i] = (double)i * t[i-1] * T / (double)(i+1);
+    evalThermo(T);
+    H.resize(m_th_nsp);
+    const double RT = R * T;
+    for (unsigned int i=0; i!=m_th_nsp; ++i) {
+        H[i] = RT * m_th_h[i];
     }
-    t[n-1] = R;
-
-    // Sum terms in polynomial for Hs.
-    sumTerms(T, t, n, H);
 }
 
 // Calculates enthalpies of all species.
 void IdealGas::CalcHs_RT(double T, fvector &H) const
 {
-    int i, n;
-    double t[Thermo::H_PARAM_COUNT];
-
-    // Ensure output array has sufficient length.
-    H.resize(Species()->size());
-
-    // Precalculate temperature terms.
-    t[0] = 1.0;
-    n = Thermo::H_PARAM_COUNT;
-    for (i=1; i<n-1; i++) {
-        t[i] = (double)i * t[i-1] * T / (double)(i+1);
-    }
-    t[n-1] = 1.0 / T;
-
-    // Sum terms in polynomial for H.
-    sumTerms(T, t, n, H);
+    evalThermo(T);
+    H.assign(m_th_h.begin(), m_th_h.end());
 }
 
 // Calculates the bulk enthalpy and the enthalpies
@@ -302,47 +282,18 @@ double IdealGas::CalcBulkH_RT(double T,
 // Calculates entropies of all species.
 void IdealGas::CalcSs(double T, fvector &S) const
 {
-    int i, n;
-    double t[Thermo::S_PARAM_COUNT];
-
-    // Ensure output array has sufficient length.
-    S.resize(Species()->size());
-
-    // Precalculate temperature terms.
-    n = Thermo::S_PARAM_COUNT;
-    t[0] = R * log(T);
-    t[1] = R * T;
-    for (i=2; i!=n-2; ++i) {
-        t[i] = (double)(i-1) * t[i-1] * T / (double)i;
+    evalThermo(T);
+    S.resize(m_th_nsp);
+    for (unsigned int i=0; i!=m_th_nsp; ++i) {
+        S[i] = R * m_th_s[i];
     }
-    t[n-2] = 0.0;
-    t[n-1] = R;
-
-    // Sum terms in polynomial for Ss.
-    sumTerms(T, t, n, S);
 }
 
 // Calculates dimensionless entropies of all species.
 void IdealGas::CalcSs_R(double T, fvector &S) const
 {
-    int i, n;
-    double t[Thermo::S_PARAM_COUNT];
-
-    // Ensure output array has sufficient length.
-    S.resize(Species()->size());
-
-    // Precalculate temperature terms.
-    n = Thermo::S_PARAM_COUNT;
-    t[0] = log(T);
-    t[1] = T;
-    for (i=2; i<n-2; i++) {
-        t[i] = (double)(i-1) * t[i-1] * T / (double)i;
-    }
-    t[n-2] = 0.0;
-    t[n-1] = 1.0;
-
-    // Sum terms in polynomial for Ss.
-    sumTerms(T, t, n, S);
+    evalThermo(T);
+    S.assign(m_th_s.begin(), m_th_s.end());
 }
 
 // Calculates the bulk entropy and the entropies of
@@ -397,48 +348,22 @@ double IdealGas::CalcBulkS_R(double T,
 // Calculates molar Gibbs free energies of each species.
 void IdealGas::CalcGs(double T, fvector &G) const
 {
-    unsigned int i, n;
-    double t[Thermo::S_PARAM_COUNT];
-
-    // Ensure output array has sufficient length.
-    G.resize(Species()->size());
-
-    // Precalculate temperature terms.
-    n = Thermo::S_PARAM_COUNT;
-    t[1] = - R * T;
-    t[0] = t[1] * (log(T) - 1.0);
-    t[S_PARAM_COUNT-1] = t[1];
-    t[1] *= 0.5 * T;
-    for (i=2; i!=Thermo::CP_PARAM_COUNT; ++i) {
-        t[i] = (double)(i-1) * t[i-1] * T / (double)(i+1);
+    evalThermo(T);
+    G.resize(m_th_nsp);
+    const double RT = R * T;
+    for (unsigned int i=0; i!=m_th_nsp; ++i) {
+        G[i] = RT * (m_th_h[i] - m_th_s[i]);
     }
-    t[H_PARAM_COUNT-1] = R;
-
-    // Sum terms in polynomial for G.
-    sumTerms(T, t, n, G);
 }
 
 // Calculates molar Gibbs free energies of each species.
 void IdealGas::CalcGs_RT(double T, fvector &G) const
 {
-    unsigned int i, n;
-    double t[Thermo::S_PARAM_COUNT];
-
-    // Ensure output array has sufficient length.
-    G.resize(Species()->size());
-
-    // Precalculate temperature terms.
-    t[0] = 1.0 - log(T);
-    t[1] = - 0.5 * T;
-    for (i=2; i!=Thermo::CP_PARAM_COUNT; ++i) {
-        t[i] = (double)(i-1) * t[i-1] * T / (double)(i+1);
+    evalThermo(T);
+    G.resize(m_th_nsp);
+    for (unsigned int i=0; i!=m_th_nsp; ++i) {
+        G[i] = m_th_h[i] - m_th_s[i];
     }
-    t[H_PARAM_COUNT-1] = 1.0 / T;
-    t[S_PARAM_COUNT-1] = - 1.0;
-
-    // Sum terms in polynomial for Cps.
-    n = Thermo::S_PARAM_COUNT;
-    sumTerms(T, t, n, G);
 }
 
 // Calculates the species' Gibbs free energies given the temperature and
@@ -519,41 +444,18 @@ double IdealGas::CalcBulkG_RT(double T,
 // Calculates molar heat capacity at const. P of all species.
 void IdealGas::CalcCps(double T, fvector &Cp) const
 {
-    int i, n;
-    double t[Thermo::CP_PARAM_COUNT];
-
-    // Ensure output array has sufficient length.
-    Cp.resize(Species()->size());
-
-    // Precalculate temperature terms.
-    n = Thermo::CP_PARAM_COUNT;
-    t[0] = R;
-    for (i=1; i<n; i++) {
-        t[i] = t[i-1] * T;
+    evalThermo(T);
+    Cp.resize(m_th_nsp);
+    for (unsigned int i=0; i!=m_th_nsp; ++i) {
+        Cp[i] = R * m_th_cp[i];
     }
-
-    // Sum terms in polynomial for Cps.
-    sumTerms(T, t, n, Cp);
 }
 
 // Calculates dimensionless molar heat capacity at const. P of all species.
 void IdealGas::CalcCps_R(double T, fvector &Cp) const
 {
-    int i, n;
-    double t[Thermo::CP_PARAM_COUNT];
-
-    // Ensure output array has sufficient length.
-    Cp.resize(Species()->size());
-
-    // Precalculate temperature terms.
-    n = Thermo::CP_PARAM_COUNT;
-    t[0] = 1.0;
-    for (i=1; i<n; i++) {
-        t[i] = t[i-1] * T;
-    }
-
-    // Sum terms in polynomial for Cps.
-    sumTerms(T, t, n, Cp);
+    evalThermo(T);
+    Cp.assign(m_th_cp.begin(), m_th_cp.end());
 }
 
 // Calculates the mean molar heat capacity at const. P.
@@ -686,54 +588,15 @@ void IdealGas::CalcCpHSs(double T,
                          fvector &H,
                          fvector &S) const
 {
-    unsigned int i, k, nc, nh, ns;
-    double tc[CP_PARAM_COUNT], th[H_PARAM_COUNT], ts[S_PARAM_COUNT];
-    const THERMO_PARAMS *a;
-
-    // Ensure output arrays have sufficient length.
-    Cp.resize(Species()->size());
-    H.resize(Species()->size());
-    S.resize(Species()->size());
-
-    // Precalculate temperature terms.
-    nc = CP_PARAM_COUNT;
-    nh = H_PARAM_COUNT;
-    ns = S_PARAM_COUNT;
-
-    tc[0] = R;
-    th[0] = R;
-    ts[0] = R * log(T);
-    tc[1] = R * T;
-    th[1] = R * T / 2.0;
-    ts[1] = R * T;
-
-    for (i=2; i<nc; i++) {
-        tc[i] = tc[i-1] * T;
-        th[i] = th[i-1] * T * (double)i / (double)(i+1);
-        ts[i] = ts[i-1] * T * (double)(i-1) / (double)i;
-    }
-    th[nh-1] = R;
-    ts[nh-1] = 0.0;
-    ts[ns-1] = R;
-
-    // Sum terms in polynomials.
-    for (i=0; i!=Species()->size(); ++i) {
-        // Set sums to 0 initially.
-        Cp[i] = H[i] = S[i] = 0.0;
-
-        // Get the thermo fitting parameters for this species
-        // at this temperature.
-        a = &(*Species())[i]->ThermoParams(T);
-
-        // Calculate the thermo property for this species.
-        for (k=0; k<nc; k++) {
-            Cp[i] += a->Params[k] * tc[k];
-            H[i]  += a->Params[k] * th[k];
-            S[i]  += a->Params[k] * ts[k];
-        }
-        H[i] += a->Params[nh-1] * th[nh-1];
-        S[i] += a->Params[nh-1] * ts[nh-1];
-        S[i] += a->Params[ns-1] * ts[ns-1];
+    evalThermo(T);
+    Cp.resize(m_th_nsp);
+    H.resize(m_th_nsp);
+    S.resize(m_th_nsp);
+    const double RT = R * T;
+    for (unsigned int i=0; i!=m_th_nsp; ++i) {
+        Cp[i] = R * m_th_cp[i];
+        H[i]  = RT * m_th_h[i];
+        S[i]  = R * m_th_s[i];
     }
 }
 
@@ -746,55 +609,10 @@ void IdealGas::CalcCpHSs_RT(double T,
                             fvector &H,
                             fvector &S) const
 {
-    unsigned int i, k, nc, nh, ns;
-    double tc[CP_PARAM_COUNT], th[H_PARAM_COUNT], ts[S_PARAM_COUNT];
-    const THERMO_PARAMS *a;
-
-    // Ensure output arrays have sufficient length.
-    Cp.resize(Species()->size());
-    H.resize(Species()->size());
-    S.resize(Species()->size());
-
-    // Precalculate temperature terms.
-    nc = CP_PARAM_COUNT;
-    nh = H_PARAM_COUNT;
-    ns = S_PARAM_COUNT;
-
-    tc[0] = 1.0;
-    th[0] = 1.0;
-    ts[0] = log(T);
-    tc[1] = T;
-    th[1] = T / 2.0;
-    ts[1] = T;
-
-    for (i=2; i!=nc; ++i) {
-        tc[i] = tc[i-1] * T;
-        th[i] = th[i-1] * T * (double)i / (double)(i+1);
-        ts[i] = ts[i-1] * T * (double)(i-1) / (double)i;
-    }
-    th[nh-1] = 1.0 / T;
-    ts[nh-1] = 0.0;
-    ts[ns-1] = 1.0;
-
-    // Sum terms in polynomials.
-    for (i=0; i!=Species()->size(); ++i) {
-        // Set sums to 0 initially.
-        Cp[i] = H[i] = S[i] = 0.0;
-
-        // Get the thermo fitting parameters for this species
-        // at this temperature.
-        a = &(*Species())[i]->ThermoParams(T);
-
-        // Calculate the thermo property for this species.
-        for (k=0; k<nc; k++) {
-            Cp[i] += a->Params[k] * tc[k];
-            H[i]  += a->Params[k] * th[k];
-            S[i]  += a->Params[k] * ts[k];
-        }
-        H[i] += a->Params[nh-1] * th[nh-1];
-        S[i] += a->Params[nh-1] * ts[nh-1];
-        S[i] += a->Params[ns-1] * ts[ns-1];
-    }
+    evalThermo(T);
+    Cp.assign(m_th_cp.begin(), m_th_cp.end());
+    H.assign(m_th_h.begin(), m_th_h.end());
+    S.assign(m_th_s.begin(), m_th_s.end());
 }
 
 
@@ -827,34 +645,99 @@ Serial_MixtureType IdealGas::SerialType() const
 
 // PRIVATE FUNCTIONS.
 
-// Calculates a polynomial fit of any thermo property given the
-// temperature terms.  The polynomial coefficients are found per
-// species.
-void IdealGas::sumTerms(double T, double *t, int n, std::vector<double> &Xs) const
-{
-    unsigned int i;
-    int k;
-    const THERMO_PARAMS *a;
-
-    for (i=0; i!=min(Species()->size(),Xs.size()); ++i) {
-        // Set sums to zero initially. // 	evaluated for each species, so can separate between gas and surf species later
-        Xs[i] = 0.0;
-
-        // Get the thermo fitting parameters for this species
-        // at this temperature.
-        a = &(*Species())[i]->ThermoParams(T);
-
-        // Calculate the thermo property for this species.
-        for (k=0; k!=n; ++k) {
-            Xs[i] += a->Params[k] * t[k];
+// Packs the thermo fitting parameters of the species into contiguous
+// arrays, ordered by range and parameter with the species innermost.
+// The upper temperature of each range except the last is held in the
+// same order, with ranges which a species does not have set to an
+// unreachable temperature.  This is repeated only if the species list
+// changes; the thermo data are assumed fixed once a mixture uses them.
+void IdealGas::packThermo(void) const
+{
+    const SpeciesPtrVector *sp = Species();
+    const unsigned int nsp = (sp == NULL) ? 0 : sp->size();
+    if ((sp == m_th_species) && (nsp == m_th_nsp)) return;
+
+    unsigned int i, k, r;
+
+    // Number of ranges.
+    m_th_nrange = 1;
+    for (i=0; i!=nsp; ++i) {
+        m_th_nrange = max(m_th_nrange, (*sp)[i]->ThermoRangeCount());
+    }
+
+    m_th_tmax.assign((m_th_nrange - 1) * nsp, 1.0e300);
+    m_th_coef.assign(m_th_nrange * S_PARAM_COUNT * nsp, 0.0);
+    for (i=0; i!=nsp; ++i) {
+        // Ranges in order of their upper temperature, which is the map
+        // key used by Species::ThermoParams().
+        const ThermoMap &map = (*sp)[i]->ThermoParamsMap();
+        r = 0;
+        for (ThermoMap::const_iterator j=map.begin(); j!=map.end(); ++j, ++r) {
+            if (r + 1 < map.size()) m_th_tmax[r*nsp + i] = j->first;
+            for (k=0; k!=S_PARAM_COUNT; ++k) {
+                m_th_coef[(r*S_PARAM_COUNT + k)*nsp + i] = j->second.Params[k];
+            }
         }
     }
-}
-
-
-
-
 
+    m_th_species = sp;
+    m_th_nsp     = nsp;
+    m_th_T       = -1.0;
+    m_th_active.resize(S_PARAM_COUNT * nsp);
+    m_th_cp.resize(nsp);
+    m_th_h.resize(nsp);
+    m_th_s.resize(nsp);
+}
+
+// Evaluates the dimensionless heat capacities (Cp/R), enthalpies (H/RT)
+// and entropies (S/R) of all species, unless T is the temperature of the
+// last evaluation.  The range of each species is found once, its
+// coefficients are gathered into contiguous arrays, and the polynomials
+// are then evaluated in loops over species which the compiler can
+// vectorise.
+void IdealGas::evalThermo(double T) const
+{
+    packThermo();
+    if (T == m_th_T) return;
+
+    const unsigned int nsp = m_th_nsp;
+    unsigned int i, k, r;
+    if (nsp == 0) return;
+
+    // Gather the coefficients of the range valid at T.  A temperature
+    // on a range boundary belongs to the lower range, as in
+    // Species::ThermoParams().
+    for (i=0; i!=nsp; ++i) {
+        r = 0;
+        while ((r + 1 < m_th_nrange) && (T > m_th_tmax[r*nsp + i])) ++r;
+        for (k=0; k!=S_PARAM_COUNT; ++k) {
+            m_th_active[k*nsp + i] = m_th_coef[(r*S_PARAM_COUNT + k)*nsp + i];
+        }
+    }
 
+    const double *const a0 = &m_th_active[0];
+    const double *const a1 = a0 + nsp;
+    const double *const a2 = a1 + nsp;
+    const double *const a3 = a2 + nsp;
+    const double *const a4 = a3 + nsp;
+    const double *const a5 = a4 + nsp;
+    const double *const a6 = a5 + nsp;
+    double *const cp = &m_th_cp[0];
+    double *const h  = &m_th_h[0];
+    double *const s  = &m_th_s[0];
+    const double lnT = log(T), invT = 1.0 / T;
 
+    for (i=0; i!=nsp; ++i) {
+        cp[i] = a0[i] + T * (a1[i] + T * (a2[i] + T * (a3[i] + T * a4[i])));
+    }
+    for (i=0; i!=nsp; ++i) {
+        h[i] = a0[i] + T * ((a1[i] / 2.0) + T * ((a2[i] / 3.0) + T * ((a3[i] / 4.0) + T * (a4[i] / 5.0))))
+             + (a5[i] * invT);
+    }
+    for (i=0; i!=nsp; ++i) {
+        s[i] = (a0[i] * lnT) + T * (a1[i] + T * ((a2[i] / 2.0) + T * ((a3[i] / 3.0) + T * (a4[i] / 4.0))))
+             + a6[i];
+    }
 
+    m_th_T = T;
+}
@@ -339,6 +339,9 @@ void Mechanism::SetUnits(Sprog::UnitSystem u)
                 }
             }
 
+            // The packed rate data hold copies of the parameters.
+            m_rxns.Update();
+
             m_units = SI;
         }
     } else if (u == CGS) {
@@ -839,6 +842,13 @@ Kinetics::Reaction * Mechanism::GetReactions(unsigned int i)
     return m_rxns[i];
 }
 
+// Rebuilds the reaction set rate data.  This must be called after
+// reactions have been modified through GetReactions().
+void Mechanism::UpdateReactions()
+{
+    m_rxns.Update();
+}
+
 // Adds an empty reaction to the mechanism.
 Sprog::Kinetics::Reaction *const Mechanism::AddReaction()
 {
@@ -48,17 +48,77 @@
 #include <vector>
 #include <stdexcept>
 #include <boost/serialization/vector.hpp>
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 //#include <bits/stl_vector.h>
 
 using namespace Sprog;
 using namespace Sprog::Thermo;
 using namespace std;
 
+// Transport property cache.  The values are valid for the mole fractions
+// and temperature held in state, which is empty when nothing is cached.
+// Each mixture owns its cache, and the lock serialises the threads that
+// share a mixture, such as those of the parallel LPDA.
+struct Mixture::TransportCache
+{
+    fvector state;          // Mole fractions and temperature.
+    bool has_visc;          // Is visc valid?
+    double visc;            // Viscosity.
+    bool has_cond;          // Is cond valid?
+    double cond;            // Thermal conductivity.
+    double cond_p;          // Pressure for cond.
+    unsigned long hits;     // Requests served from the cache.
+    unsigned long misses;   // Requests that were calculated.
+#ifdef _OPENMP
+    omp_lock_t lock;
+#endif
+
+    TransportCache()
+    : has_visc(false), visc(0.0), has_cond(false), cond(0.0), cond_p(0.0),
+      hits(0), misses(0)
+    {
+#ifdef _OPENMP
+        omp_init_lock(&lock);
+#endif
+    }
+
+    ~TransportCache()
+    {
+#ifdef _OPENMP
+        omp_destroy_lock(&lock);
+#endif
+    }
+
+    void Lock()
+    {
+#ifdef _OPENMP
+        omp_set_lock(&lock);
+#endif
+    }
+
+    void Unlock()
+    {
+#ifdef _OPENMP
+        omp_unset_lock(&lock);
+#endif
+    }
+
+private:
+    // The lock cannot be copied.
+    TransportCache(const TransportCache &);
+    TransportCache &operator=(const TransportCache &);
+};
+
 // CONSTRUCTORS AND DESTRUCTORS.
 
 // Default constructor (private).
 Mixture::Mixture(void)
-: m_vmodel(Sprog::iAir)
+: m_vmodel(Sprog::iAir),
+  m_tc(new TransportCache())
 {
     m_data.clear();
     m_species = NULL;
@@ -66,7 +126,8 @@ Mixture::Mixture(void)
 
 // Default constructor (public, requires species list).
 Mixture::Mixture(const SpeciesPtrVector &sp)
-: m_vmodel(Sprog::iAir)
+: m_vmodel(Sprog::iAir),
+  m_tc(new TransportCache())
 {
     SetSpecies(sp);
 }
@@ -82,7 +143,8 @@ Mixture::Mixture(const SpeciesPtrVector &sp, const int NumGasSp, const int NumSu
 
 // Copy constructor.
 Mixture::Mixture(const Mixture &copy)
-: m_vmodel(copy.m_vmodel)
+: m_vmodel(copy.m_vmodel),
+  m_tc(new TransportCache())
 {
     *this = copy;
 }
@@ -90,6 +152,7 @@ Mixture::Mixture(const Mixture &copy)
 
 // Stream-reading constructor.
 Mixture::Mixture(std::istream &in, const SpeciesPtrVector &sp)
+: m_tc(new TransportCache())
 {
     Deserialize(in);
     SetSpecies(sp);
@@ -99,6 +162,7 @@ Mixture::Mixture(std::istream &in, const SpeciesPtrVector &sp)
 Mixture::~Mixture(void)
 {
     m_data.clear();
+    delete m_tc;
 }
 
 
@@ -113,6 +177,19 @@ Mixture &Mixture::operator=(const Mixture &mix)
         m_species = mix.m_species;
 		gasSpeciesCount = mix.gasSpeciesCount;
 		surfSpeciesCount = mix.surfSpeciesCount; 
+
+        // The cached transport properties remain valid for the copied
+        // state, but the hit and miss counts belong to the original.
+        mix.m_tc->Lock();
+        m_tc->Lock();
+        m_tc->state    = mix.m_tc->state;
+        m_tc->has_visc = mix.m_tc->has_visc;
+        m_tc->visc     = mix.m_tc->visc;
+        m_tc->has_cond = mix.m_tc->has_cond;
+        m_tc->cond     = mix.m_tc->cond;
+        m_tc->cond_p   = mix.m_tc->cond_p;
+        m_tc->Unlock();
+        mix.m_tc->Unlock();
     }
 
     return *this;
@@ -670,6 +747,7 @@ void Mixture::SetSpecies(const Sprog::SpeciesPtrVector &sp)
 {
     m_species = &sp;
     m_data.resize(m_species->size()+sNumNonSpeciesData);
+    clearTransportCache();
 
 	gasSpeciesCount =0;
 
@@ -751,8 +829,25 @@ double Mixture::getMeanCollisionSection() const { // Restricted to gas phase (mm
 // returns the mixture viscosity in Kg/m-s
 double Mixture::getViscosity() const{
 
+    m_tc->Lock();
+    if (transportStateMatches() && m_tc->has_visc) {
+        ++m_tc->hits;
+        const double eta = m_tc->visc;
+        m_tc->Unlock();
+        return eta;
+    }
+    ++m_tc->misses;
+    m_tc->Unlock();
+
 	Sprog::Transport::MixtureTransport mt;
-	return mt.getViscosity(Temperature(),*this);
+	const double eta = mt.getViscosity(Temperature(),*this);
+
+    m_tc->Lock();
+    if (!transportStateMatches()) resetTransportCache();
+    m_tc->visc = eta;
+    m_tc->has_visc = true;
+    m_tc->Unlock();
+    return eta;
 }
 
 
@@ -779,8 +874,91 @@ void Mixture::checkForTransportData() const
 
 // returns the mixture thermal conductivity in J/m-s-K
 double Mixture::getThermalConductivity(double pre) const{
+
+    m_tc->Lock();
+    if (transportStateMatches() && m_tc->has_cond && (m_tc->cond_p == pre)) {
+        ++m_tc->hits;
+        const double lambda = m_tc->cond;
+        m_tc->Unlock();
+        return lambda;
+    }
+    ++m_tc->misses;
+    m_tc->Unlock();
+
 	Sprog::Transport::MixtureTransport mt;
-	return mt.getThermalConductivity(Temperature(),pre,*this);
+	const double lambda = mt.getThermalConductivity(Temperature(),pre,*this);
+
+    m_tc->Lock();
+    if (!transportStateMatches()) resetTransportCache();
+    m_tc->cond = lambda;
+    m_tc->cond_p = pre;
+    m_tc->has_cond = true;
+    m_tc->Unlock();
+    return lambda;
+}
+
+
+// TRANSPORT PROPERTY CACHE.
+//
+// Transport properties are requested for every coagulation event, but the
+// Chapman-Enskog viscosity costs O(Nsp^2) operations and several allocations.
+// The last values are therefore cached along with the mole fractions and
+// temperature from which they were calculated.  RawData() lets the ODE solvers
+// change the state without going through the setters, so rather than keeping
+// a modification counter the key is compared with the current state, which
+// costs O(Nsp).  The cache members are only touched with the cache locked;
+// the properties themselves are calculated outside the lock.
+
+// Returns true if the cache key matches the current mixture state.  The
+// cache must be locked.
+bool Mixture::transportStateMatches() const
+{
+    const size_t n = temperatureIndex() + 1;
+    return (m_tc->state.size() == n) &&
+           std::equal(m_tc->state.begin(), m_tc->state.end(), m_data.begin());
+}
+
+// Sets the cache key to the current state and discards all cached values.
+// The cache must be locked.
+void Mixture::resetTransportCache() const
+{
+    m_tc->state.assign(m_data.begin(), m_data.begin() + temperatureIndex() + 1);
+    m_tc->has_visc = false;
+    m_tc->has_cond = false;
+}
+
+// Discards the cache key and all cached values.
+void Mixture::clearTransportCache() const
+{
+    m_tc->Lock();
+    m_tc->state.clear();
+    m_tc->Unlock();
+}
+
+// Number of viscosity and conductivity requests served from the cache.
+unsigned long Mixture::TransportCacheHits() const
+{
+    m_tc->Lock();
+    const unsigned long n = m_tc->hits;
+    m_tc->Unlock();
+    return n;
+}
+
+// Number of viscosity and conductivity requests that were calculated.
+unsigned long Mixture::TransportCacheMisses() const
+{
+    m_tc->Lock();
+    const unsigned long n = m_tc->misses;
+    m_tc->Unlock();
+    return n;
+}
+
+// Zeroes the transport cache hit and miss counters.
+void Mixture::ResetTransportCacheStats()
+{
+    m_tc->Lock();
+    m_tc->hits = m_tc->misses = 0;
+    m_tc->Unlock();
 }
 
 const vector<double> Mixture::getMolarSpecificHeat(){
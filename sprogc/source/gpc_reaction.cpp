@@ -49,6 +49,7 @@
 #include <stdexcept>
 #include <string>
 #include <math.h>
+#include <limits>
 #include "string_functions.h"
 
 using namespace Sprog;
@@ -69,6 +70,8 @@ Reaction::Reaction(void)
     m_arrr       = NULL;
     m_lt         = NULL;
     m_revlt      = NULL;
+    m_tmin       = 0.0;
+    m_tmax       = std::numeric_limits<double>::max();
     m_fo.F_k     = 0.0;
     m_fo.spName  = "";
     m_covr.Eta   = m_covr.Miu = m_covr.Epsilon =0.0;  
@@ -113,6 +116,8 @@ Reaction::Reaction(std::istream &in)
     m_arrr       = NULL;
     m_lt         = NULL;
     m_revlt      = NULL;
+    m_tmin       = 0.0;
+    m_tmax       = std::numeric_limits<double>::max();
     m_fo.F_k     = 0.0;
     m_fo.spName  = "";
     m_covr.Eta   = m_covr.Miu = m_covr.Epsilon =0.0;  
@@ -200,6 +205,10 @@ Reaction &Reaction::operator=(const Sprog::Kinetics::Reaction &rxn)
         if (rxn.m_lt != NULL) m_lt = new LTCOEFFS(*rxn.m_lt);
         if (rxn.m_revlt != NULL) m_revlt = new LTCOEFFS(*rxn.m_revlt);
 
+        // Copy temperature range.
+        m_tmin = rxn.m_tmin;
+        m_tmax = rxn.m_tmax;
+
 	// Copy FORD and COVERAGE 
         m_covr = rxn.m_covr;
 	m_fo = rxn.m_fo;
@@ -646,6 +655,23 @@ void Reaction::SetRevArrhenius(const Sprog::Kinetics::ARRHENIUS &arr)
 
 
 
+// TEMPERATURE RANGE.
+
+// Sets the temperature range [tmin, tmax) outside which the forward rate
+// constant is zero.  A reverse rate found by equilibrium is then also zero,
+// but explicit reverse rate parameters still apply.
+void Reaction::SetTemperatureRange(double tmin, double tmax)
+{
+    if ((tmin < 0.0) || (tmin >= tmax)) {
+        throw invalid_argument("Invalid reaction temperature range "
+                               "(Sprog, Reaction::SetTemperatureRange).");
+    }
+    m_tmin = tmin;
+    m_tmax = tmax;
+}
+
+
+
 // LANDAU TELLER COEFFICIENTS.
 
 // Sets the forward Landau Teller rate parameters.
@@ -1423,6 +1449,8 @@ void Reaction::releaseMemory(void)
     m_lt = NULL;
     if (m_revlt != NULL) delete m_revlt;
     m_revlt = NULL;
+    m_tmin = 0.0;
+    m_tmax = std::numeric_limits<double>::max();
     m_fo.F_k     = 0.0;
     m_fo.spName  = "";
     m_covr.Eta   = m_covr.Miu = m_covr.Epsilon =0.0;  
@@ -1458,7 +1486,7 @@ void Reaction::Serialize(std::ostream &out) const
         const unsigned int falseval = 0;
 	unsigned int u;
         // Write the serialisation version number to the stream.
-        const unsigned int version = 0;
+        const unsigned int version = 1;
         out.write((char*)&version, sizeof(version));
 
         // Write the length of the reaction name to the stream.
@@ -1710,6 +1738,10 @@ void Reaction::Serialize(std::ostream &out) const
         // There is no way of outputting custom fall-off functions at the moment.
         // This needs to corrected in the future.
 
+        // Write temperature range.
+        out.write((char*)&m_tmin, sizeof(m_tmin));
+        out.write((char*)&m_tmax, sizeof(m_tmax));
+
     } else {
         throw invalid_argument("Output stream not ready (Sprog, Reaction::Serialize).");
     }
@@ -1733,6 +1765,7 @@ void Reaction::Deserialize(std::istream &in)
 
         switch (version) {
             case 0:
+            case 1:
                 // Read the length of the reaction name.
                 in.read(reinterpret_cast<char*>(&n), sizeof(n));
 
@@ -2041,6 +2074,12 @@ void Reaction::Deserialize(std::istream &in)
                     m_foparams.Params[i] = (double)A;
                 }
 
+                // Read temperature range.
+                if (version > 0) {
+                    in.read(reinterpret_cast<char*>(&m_tmin), sizeof(m_tmin));
+                    in.read(reinterpret_cast<char*>(&m_tmax), sizeof(m_tmax));
+                }
+
                 break;
             default:
                 throw runtime_error("Reaction serialized version number is "
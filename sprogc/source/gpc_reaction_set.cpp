@@ -129,7 +129,8 @@ ReactionSet &ReactionSet::operator=(const ReactionSet &rxns)
 	// Build MOTT WISE reaction map.
 	m_mottw_rxns = rxns.m_mottw_rxns; 
 
-	// Build 
+	// Build packed rate data.
+	pack();
     }
 
     return *this;
@@ -214,6 +215,8 @@ ReactionSet &ReactionSet::operator+=(const ReactionSet &rxns)
             m_mottw_rxns.push_back(n + *jrxn);
         }
 
+        // Build packed rate data.
+        pack();
     }
 
     return *this;
@@ -327,6 +330,17 @@ Reaction *const ReactionSet::AddReaction(const Sprog::Kinetics::Reaction &rxn)
         m_mottw_rxns.push_back(m_rxns.size()-1);
     }
 
+    // Update the packed rate data.  Gas-phase reactions are taken to
+    // precede the surface reactions, so the packing only has to be
+    // redone once surface reactions are present.
+    if (m_surface_rxns.empty()) {
+        packReaction(m_rxns.size()-1);
+        packArrhenius(m_rxns.size()-1);
+        packThirdBodies(m_rxns.size()-1);
+    } else {
+        pack();
+    }
+
     return pr;
 }
 
@@ -457,9 +471,8 @@ double ReactionSet::GetSurfaceMolarProdRates(const fvector &rop,
 double ReactionSet::GetMolarProdRates(const Sprog::Thermo::GasPhase &gas,
                                     fvector &wdot) const
 {
-    static fvector rop;
-    GetRatesOfProgress(gas, rop);//  Calling GetRatesofProgress 4 
-    return GetMolarProdRates(rop, wdot); // Caling GetMolarProdRates 1
+    GetRatesOfProgress(gas, m_wk_rop);//  Calling GetRatesofProgress 4 
+    return GetMolarProdRates(m_wk_rop, wdot); // Caling GetMolarProdRates 1
 }
 
 // Calculates the molar production rates of all species.GetMolarProdRates 3
@@ -468,9 +481,8 @@ double ReactionSet::GetMolarProdRates(double T, double density, const double *x,
                                     const Sprog::Thermo::ThermoInterface &thermo,
                                     fvector &wdot) const
 {
-    static fvector rop;
-    GetRatesOfProgress(T, density, x, n, thermo, rop); //  Calling GetRatesofProgress6
-    return GetMolarProdRates(rop, wdot); // Caling GetMolarProdRates 1
+    GetRatesOfProgress(T, density, x, n, thermo, m_wk_rop); //  Calling GetRatesofProgress6
+    return GetMolarProdRates(m_wk_rop, wdot); // Caling GetMolarProdRates 1
 }
 
 
@@ -480,9 +492,8 @@ double ReactionSet::GetSurfaceMolarProdRates(double T, double density, const dou
                                     const Sprog::Thermo::ThermoInterface &thermo,
                                     fvector &sdot) const
 {
-    static fvector rop;
-    GetRatesOfProgress(T, density, x, n, thermo, rop); //  Calling GetRatesofProgress6
-    return GetSurfaceMolarProdRates(rop, sdot); // Caling GetMolarProdRates 1
+    GetRatesOfProgress(T, density, x, n, thermo, m_wk_rop); //  Calling GetRatesofProgress6
+    return GetSurfaceMolarProdRates(m_wk_rop, sdot); // Caling GetMolarProdRates 1
 }
 
 
@@ -530,34 +541,26 @@ void ReactionSet::GetRatesOfProgress(double density,
 
 	unsigned int size_gas_rxns = m_rxns.size() - m_surface_rxns.size();
 
+        // Species concentrations.
+        m_wk_conc.resize(n);
+        for (k=0; k!=(int)n; ++k) {
+            m_wk_conc[k] = density * x[k];
+        }
+
+        // Use rfwd to store forward rates of production,
+        // and rrev to store reverse rates.  The packed products
+        // multiply the rate constants by the integer powers of the
+        // reactant and product concentrations.
         for (i=0; i!=size_gas_rxns; ++i) {
-            // Use rfwd to store forward rates of production,
-            // and rrev to store reverse rates.
             rfwd[i] = kforward[i];
             rrev[i] = kreverse[i];
+        }
+        m_packed_fwd.Multiply(m_wk_conc, rfwd);
+        m_packed_rev.Multiply(m_wk_conc, rrev);
 
-            // Integer reactants.
-            for (k=0; k!=m_rxns[i]->ReactantCount(); ++k) {
-                // As the stoichiometry is integer, it is more computationally efficient
-                // to multiply the values together than to use the pow() function.
-                for (j=0; j!=m_rxns[i]->Reactants()[k].Mu(); ++j) {
-                    rfwd[i] *= density * x[m_rxns[i]->Reactants()[k].Index()];
-                }
-            }
-
-            // Integer products.
-            for (k=0; k!=m_rxns[i]->ProductCount(); ++k) {
-                // As the stoichiometry is integer, it is more computationally efficient
-                // to multiply the values together than to use the pow() function.
-                for (j=0; j!=m_rxns[i]->Products()[k].Mu(); ++j) {
-                    rrev[i] *= density * x[m_rxns[i]->Products()[k].Index()];
-                }
-            }
-
-            // Calculate the net rates of production.
+        // Calculate the net rates of production.
+        for (i=0; i!=size_gas_rxns; ++i) {
             rop[i] = rfwd[i] - rrev[i];
-	    //cout << "ROP Gas" << rop[i] << endl;
-	    //cout << "is surface? " << m_rxns[i]->IsSURF() << endl;
         }
 
 	
@@ -740,8 +743,7 @@ void ReactionSet::GetRatesOfProgress(double density,
                                      const fvector &kreverse,
                                      fvector &rop) const
 {
-    static fvector rfwd, rrev;
-    GetRatesOfProgress(density, x, n, kforward, kreverse, rop, rfwd, rrev); // Calling GetRatesOfProgress 1
+    GetRatesOfProgress(density, x, n, kforward, kreverse, rop, m_wk_rfwd, m_wk_rrev); // Calling GetRatesOfProgress 1
 }
 
 // Returns the rates of progress of all reactions given the mixture
@@ -761,9 +763,8 @@ void ReactionSet::GetRatesOfProgress(const Sprog::Thermo::GasPhase &mix,
 // Calculates the rate of progress of each reaction. GetRatesOfProgress 4
 void ReactionSet::GetRatesOfProgress(const Sprog::Thermo::GasPhase &gas, fvector &rop) const
 {
-    static fvector kf, kr;
-    GetRateConstants(gas, kf, kr); // Calling GetRateConstants 4
-    GetRatesOfProgress(gas, kf, kr, rop);// Calling GetRatesOfProgress 3
+    GetRateConstants(gas, m_wk_kf, m_wk_kr); // Calling GetRateConstants 4
+    GetRatesOfProgress(gas, m_wk_kf, m_wk_kr, rop);// Calling GetRatesOfProgress 3
 }
 
 // Calculates the rate of progress of each reaction. GetRatesOfProgress 5
@@ -772,11 +773,10 @@ void ReactionSet::GetRatesOfProgress(const Sprog::Thermo::GasPhase &gas,
                                      fvector &rfwd,
                                      fvector &rrev) const
 {
-    static fvector kf, kr;
-    GetRateConstants(gas, kf, kr); // Calling GetRateConstants 4
+    GetRateConstants(gas, m_wk_kf, m_wk_kr); // Calling GetRateConstants 4
     GetRatesOfProgress(gas.Density(), &(gas.MoleFractions()[0]),
                        m_mech->Species().size(),
-                       kf, kr, rop, rfwd, rrev); // Calling GetRatesOfProgress 1
+                       m_wk_kf, m_wk_kr, rop, rfwd, rrev); // Calling GetRatesOfProgress 1
 }
 
 // Calculates the rate of progress of each reaction. GetRatesOfProgress 6
@@ -785,9 +785,8 @@ void ReactionSet::GetRatesOfProgress(double T, double density, const double *x,
                                      const Sprog::Thermo::ThermoInterface &thermo,
                                      fvector &rop) const
 {
-    static fvector kf, kr;
-    GetRateConstants(T, density, x, n, thermo, kf, kr); // Calling GetRateConstants 3
-    GetRatesOfProgress(density, x, n, kf, kr, rop); // Calling GetRatesOfProgress 2
+    GetRateConstants(T, density, x, n, thermo, m_wk_kf, m_wk_kr); // Calling GetRateConstants 3
+    GetRatesOfProgress(density, x, n, m_wk_kf, m_wk_kr, rop); // Calling GetRatesOfProgress 2
 }
 
 
@@ -805,9 +804,6 @@ void ReactionSet::GetRateConstants(double T,
                                    fvector &kf,
                                    fvector &kr) const
 {
-    static fvector tbconcs;
-    static bool fallocated = false;
-
     // Check that we have been given enough species concentrations.
     if (n < m_mech->Species().size()) {
         return;
@@ -819,11 +815,8 @@ void ReactionSet::GetRateConstants(double T,
     if (n < m_mech->Species().size()) {
         return;
     } else {
-        if (!fallocated) {
-            // Allocate temporary memory.
-            tbconcs.resize(m_rxns.size(), 0.0);
-            fallocated = true;
-        }
+        // Allocate temporary memory.
+        m_wk_tbconcs.resize(m_rxns.size(), 0.0);
         kf.resize(m_rxns.size(), 0.0);
         kr.resize(m_rxns.size(), 0.0);
     }
@@ -837,21 +830,21 @@ void ReactionSet::GetRateConstants(double T,
     // Calculate third-body concentrations for all reactions.  These
     // values will be multiplied by the rate constants, therefore if
     // a reaction does not have third-bodies then tbconcs is set to 1.0.
-    calcTB_Concs(density, x, n, tbconcs);
+    calcTB_Concs(density, x, n, m_wk_tbconcs);
 
     // Calculate the pressure-dependent fall-off terms in the rate
     // constant expressions.  This function multiplies the rate constants
     // by the fall-off terms.  This function may also change the values in
     // the tbconcs vector.
-    calcFallOffTerms(T, density, x, n, tbconcs, kf, kr);
+    calcFallOffTerms(T, density, x, n, m_wk_tbconcs, kf, kr);
 
     // Apply third-body concentrations to rate constants.  It is important
     // to apply the fall-off terms before doing this, as that routine may
     // change the values in the tbconcs vector.
     for (RxnMap::const_iterator im=m_tb_rxns.begin(); im!=m_tb_rxns.end(); ++im) {
         unsigned int j = *im;
-        kf[j] *= tbconcs[j];
-        kr[j] *= tbconcs[j];
+        kf[j] *= m_wk_tbconcs[j];
+        kr[j] *= m_wk_tbconcs[j];
     }
 }
 
@@ -877,9 +870,8 @@ void ReactionSet::GetRateConstants(double T,
                                    fvector &kforward,
                                    fvector &kreverse) const
 {
-    static fvector Gs;
-    thermo.CalcGs_RT(T, Gs);
-    GetRateConstants(T, density, x, n, Gs, kforward, kreverse); // Calling GetRateConstants 1
+    thermo.CalcGs_RT(T, m_wk_Gs);
+    GetRateConstants(T, density, x, n, m_wk_Gs, kforward, kreverse); // Calling GetRateConstants 1
 }
 
 // Calculates the forward and reverse rate constants
@@ -888,10 +880,9 @@ void ReactionSet::GetRateConstants(const Sprog::Thermo::GasPhase &mix,
                                    std::vector<double> &kforward,
                                    std::vector<double> &kreverse) const
 {
-    static fvector Gs;
-    mix.Gs_RT(Gs);
+    mix.Gs_RT(m_wk_Gs);
     GetRateConstants(mix.Temperature(), mix.Density(), &(mix.MoleFractions()[0]),
-                     m_mech->Species().size(), Gs, kforward, kreverse); // Calling GetRateConstant 3
+                     m_mech->Species().size(), m_wk_Gs, kforward, kreverse); // Calling GetRateConstant 3
 }
 
 
@@ -929,66 +920,63 @@ void ReactionSet::calcRateConstantsT(double T, const fvector &Gs,
         T_2_3 = T_1_3 * T_1_3;
     }
 
-    // Calculate classic Arrhenius forward rate expression.
-	// ljx-based on temperature range.
-	//ljx-based on temperature.
-	for (i = m_rxns.begin(), j = 0; i != m_rxns.end(); ++i, ++j) {
-		if (T < 2690){   //ljx
-			kf[j] = (*i)->Arrhenius().A * 0 *//ljx
-				exp(((*i)->Arrhenius().n * lnT) -
-				((*i)->Arrhenius().E * invRT));
-		}
-		else if (T >= 2690){                   //ljx
-			kf[j] = (*i)->Arrhenius().A *
-				exp(((*i)->Arrhenius().n * lnT) -
-				((*i)->Arrhenius().E * invRT));
-		}
-	}
+    // Calculate classic Arrhenius forward rate expression.  The exponents
+    // and the exponentials are evaluated in separate loops over the packed
+    // parameters, so that each loop can be vectorised.
+    const unsigned int nrxns = m_arr_A.size();
+    for (unsigned int r=0; r!=nrxns; ++r) {
+        kf[r] = (m_arr_n[r] * lnT) - (m_arr_E[r] * invRT);
+    }
+    for (unsigned int r=0; r!=nrxns; ++r) {
+        kf[r] = m_arr_A[r] * exp(kf[r]);
+    }
 
     // Landau-Teller rate expressions.
     for (im=m_lt_rxns.begin(); im!=m_lt_rxns.end(); ++im) {
         j = *im;
         kf[j] *= exp((m_rxns[j]->LTCoeffs()->B / T_1_3) +
                            (m_rxns[j]->LTCoeffs()->C / T_2_3));
-
-	// cout << "Landau " << kf[j] << endl; 
     }
 
+    // Forward rates are switched off outside the temperature ranges.  The
+    // equilibrium reverse rates below then vanish with them; explicit
+    // reverse rates are not affected.
+    for (k=0; k!=(int)m_trange_rxns.size(); ++k) {
+        if ((T < m_trange_min[k]) || (T >= m_trange_max[k])) {
+            kf[m_trange_rxns[k]] = 0.0;
+        }
+    }
 
-    
-    // Reverse rate constants.
-    for (i=m_rxns.begin(),j=0; i!=m_rxns.end(); ++i,++j) {
-
-	
-	  if ((*i)->RevArrhenius() != NULL) {
-            // This reaction has explicit reverse rate parameters.
-            kr[j] = (*i)->RevArrhenius()->A *
-	      exp(((*i)->RevArrhenius()->n * lnT) -
-		  ((*i)->RevArrhenius()->E * invRT));
-	  } else if ((*i)->IsReversible()) {
-            // Must find the reverse rate constants by equilibrium.
-            kr[j] = 0.0;
-
-            // Calculate the Gibbs free energy change for reaction i and sum up
-            // the stoichiometric coefficients.
-            for (k=0; k!=(*i)->ReactantCount(); ++k) {
-	      // Integer Reactants.
-	      kr[j] += (*i)->Reactants()[k].Mu() * Gs[(*i)->Reactants()[k].Index()];
-            }
-            for (k=0; k!=(*i)->ProductCount(); ++k) {
-	      // Integer Products.
-	      kr[j] -= (*i)->Products()[k].Mu() * Gs[(*i)->Products()[k].Index()];
-            }
-
-            // Calculate the reverse rate constant.
-            kr[j]  = exp(min(kr[j], log(1.0e250)));
-            kr[j] *= pow(Patm_RT, (*i)->TotalStoich());
-            kr[j]  = kf[j] / max(kr[j], 1.0e-250);
-	  }
+    // Explicit reverse rate constants.
+    const unsigned int nrev = m_revarr_A.size();
+    for (unsigned int r=0; r!=nrev; ++r) {
+        kr[m_rev_rxns[r]] = m_revarr_A[r] *
+            exp((m_revarr_n[r] * lnT) - (m_revarr_E[r] * invRT));
+    }
 
-	  // cout << "classic reverse Arrhenius " << kr[j] << endl; 
+    // Reverse rate constants found by equilibrium.
+    for (im=m_eq_rxns.begin(); im!=m_eq_rxns.end(); ++im) {
+        j = *im;
+        const Reaction &rxn = *m_rxns[j];
+        kr[j] = 0.0;
+
+        // Calculate the Gibbs free energy change for reaction j and sum up
+        // the stoichiometric coefficients.
+        for (k=0; k!=rxn.ReactantCount(); ++k) {
+            // Integer Reactants.
+            kr[j] += rxn.Reactants()[k].Mu() * Gs[rxn.Reactants()[k].Index()];
+        }
+        for (k=0; k!=rxn.ProductCount(); ++k) {
+            // Integer Products.
+            kr[j] -= rxn.Products()[k].Mu() * Gs[rxn.Products()[k].Index()];
+        }
 
+        // Calculate the reverse rate constant.
+        kr[j]  = exp(min(kr[j], log(1.0e250)));
+        kr[j] *= pow(Patm_RT, rxn.TotalStoich());
+        kr[j]  = kf[j] / max(kr[j], 1.0e-250);
     }
+
 	
     for (im=m_surface_rxns.begin(),j=0; im!=m_surface_rxns.end(); ++im) {
       j = *im; 
@@ -1438,27 +1426,16 @@ void ReactionSet::calcCOVERAGE(double T, const double *const x, fvector &kf) con
 void ReactionSet::calcTB_Concs(double density, const double *x,
                                unsigned int n, fvector &tbconcs) const
 {
-    RxnPtrVector::const_iterator i;
-    RxnMap::const_iterator im;
-    int j, k;
-
-    // Third body concentrations for each reaction.
-    for (i=m_rxns.begin(),j=0; i!=m_rxns.end(); ++i,++j)
-    {
-        if ((*i)->UseThirdBody())
-        {
-            // Calculate enhanced third body concentration using the enhancement
-            // factors defined for this reaction.
-            tbconcs[j] = 0.0;
-            for (k=0; k<(*i)->ThirdBodyCount(); ++k)
-            {
-                tbconcs[j] += ((*i)->ThirdBody(k).Mu() - 1.0) *
-                              x[(*i)->ThirdBody(k).Index()];
+    // The enhanced third-body concentrations are the product of the
+    // packed efficiency matrix with the mole fractions.
+    for (unsigned int j=0; j!=m_tb_use.size(); ++j) {
+        if (m_tb_use[j]) {
+            double sum = 0.0;
+            for (unsigned int p=m_tb_start[j]; p!=m_tb_start[j+1]; ++p) {
+                sum += m_tb_coeff[p] * x[m_tb_sp[p]];
             }
-            tbconcs[j] = density * (1.0 + tbconcs[j]);
-        }
-        else
-        {
+            tbconcs[j] = density * (1.0 + sum);
+        } else {
             // This reaction has no third body requirement.
             tbconcs[j] = density; // Changed as recommended by Will Menz
         }
@@ -1469,85 +1446,119 @@ void ReactionSet::calcTB_Concs(double density, const double *x,
 // Calculates the pressure-dependent fall-off terms in the rate
 // constant expressions.  This function multiplies the rate constants
 // by the fall-off terms.  This function may also change the values in
-// the tbconcs vector.
+// the tbconcs vector.  If dlnk is given then d(ln k)/d(ln M) of each
+// fall-off reaction is also returned in it.  The broadening factors are
+// evaluated from the packed fall-off parameters, and give the same
+// values as Reaction::FTROE3(), FTROE4() and FSRI().
 void ReactionSet::calcFallOffTerms(double T, double density, const double *x,
                                    unsigned int n, fvector &tbconcs,
-                                   fvector &kf, fvector &kr) const
+                                   fvector &kf, fvector &kr,
+                                   fvector *dlnk) const
 {
-    double lowk=0.0, pr=0.0, logpr=0.0, lnT=log(T), invRT=0.0;
-    RxnPtrVector::const_iterator i;
-    RxnMap::const_iterator im;
-    int j;
-    const Reaction *rxn;
+    const double invRT = calcInvRT(T);
+    double F = 0.0;
+    unsigned int j;
+
+    // Pressure dependent fall-off reactions.
+    for (unsigned int f=0; f!=m_fo_index.size(); ++f) {
+        j = m_fo_index[f]; // Reaction index of fth fall-off reaction.
+        F = calcFallOffFactor(f, T, invRT, density, x, kf[j], tbconcs[j],
+                              (dlnk != NULL) ? &(*dlnk)[j] : NULL);
+        kf[j] *= F;
+        kr[j] *= F;
+    }
+}
+
+// Returns the fall-off factor of the fth packed fall-off reaction.  The
+// broadening factors are evaluated from the packed fall-off parameters,
+// and give the same values as Reaction::FTROE3(), FTROE4() and FSRI().
+double ReactionSet::calcFallOffFactor(unsigned int f, double T, double invRT,
+                                      double density, const double *const x,
+                                      double kf, double &tbconc,
+                                      double *dlnk) const
+{
+    const double d = 0.14;
+    const double *const p = &m_fo_params[f * FALLOFF_PARAMS::MAX_FALLOFF_PARAMS];
+    double lowk=0.0, pr=0.0, logpr=0.0, F=0.0, dlogF=0.0;
+    double fcent=0.0, c=0.0, nt=0.0, u=0.0, w=0.0, base=0.0;
+
+    // Calculate low pressure limit.
+    lowk = m_fo_A[f] * exp((m_fo_n[f] * log(T)) - (m_fo_E[f] * invRT));
+
+    // Calculate reduced pressure.
+    if (m_fo_tb[f] >= 0) {
+        // A particular species is to be used as the third body.
+        pr = lowk * density * x[m_fo_tb[f]] / kf;
+    } else {
+        // Use all species as third bodies.
+        pr = lowk * tbconc / kf;
+        tbconc = 1.0;
+    }
+
+    // Broadening factor F and d(log10 F)/d(log10 pr).
+    logpr = log10(pr);
+    switch (m_fo_type[f]) {
+        case Troe3: // 3-parameter Troe form.
+        case Troe4: // 4-parameter Troe form.
+            fcent = ((1.0 - p[0]) * exp(-T / p[1])) + (p[0] * exp(-T / p[2]));
+            if (m_fo_type[f] == Troe4) fcent += exp(-p[3] / T);
+            fcent = log10(fcent);
+            c  = logpr - 0.4 - (0.67 * fcent);
+            nt = 0.75 - (1.27 * fcent) - (d * c);
+            u  = c / nt;
+            F  = pow(10.0, fcent / (1 + (u*u)));
+            dlogF = - fcent * 2.0 * u * ((nt + (d * c)) / (nt * nt)) /
+                    ((1.0 + (u*u)) * (1.0 + (u*u)));
+            break;
+        case SRI: // SRI form.
+            w     = 1.0 / (1.0 + (logpr * logpr));
+            base  = (p[0] * exp(-p[1] / T)) + exp(-T / p[2]);
+            F     = p[3] * pow(T, p[4]) * pow(base, w);
+            dlogF = log10(base) * (-2.0 * logpr * w * w);
+            break;
+        case Custom: // A custom function is defined to calculate the fall-off form.
+            //rxn->FallOffFn()(*rxn, lowk, tbconcs[j], T, kf[j], kr[j]);
+            throw std::runtime_error("Custom not supported yet.");
+        default: // Lindemann, F = 1.
+            F = 1.0;
+            dlogF = 0.0;
+            break;
+    }
+
+    if (dlnk != NULL) {
+        *dlnk = (1.0 / (1.0 + pr)) + dlogF;
+    }
+    pr  = pr / (1.0 + pr);
+    pr *= F;
+    return pr;
+}
 
+// Returns 1 / RT in the units of the mechanism.
+double ReactionSet::calcInvRT(double T) const
+{
     switch (m_mech->Units()) {
         case SI :
-            invRT = 1.0 / (R * T);
-            break;
+            return 1.0 / (R * T);
         case CGS :
-            invRT = 1.0 / (R_CGS * T);
-            break;
+            return 1.0 / (R_CGS * T);
         default:
             // Something has gone wrong to end up here.
-            invRT = 0.0;
-    }
-
-    // Pressure dependent fall-off reactions.
-    for (im=m_fo_rxns.begin(); im!=m_fo_rxns.end(); ++im) {
-        j   = *im;  // Reaction index of imth fall-off reaction.
-        rxn = m_rxns[j];
-
-        // Calculate low pressure limit.
-        lowk = rxn->FallOffParams().LowP_Limit.A *
-               exp((rxn->FallOffParams().LowP_Limit.n * lnT) -
-                    (rxn->FallOffParams().LowP_Limit.E * invRT));
-
-        // Calculate reduced pressure.
-        if (rxn->FallOffParams().ThirdBody >= 0) {
-            // A particular species is to be used as the third body.
-            pr = lowk * density * x[rxn->FallOffParams().ThirdBody] / kf[j];
-        } else {
-            // Use all species as third bodies.
-            pr = lowk * tbconcs[j] / kf[j];
-            tbconcs[j] = 1.0;
-        }
-
-        // Calculate rate constants based on equation form.
-        logpr = log10(pr);
-        pr    = pr / (1.0 + pr);
-        switch (rxn->FallOffType()) {
-            case Troe3: // 3-parameter Troe form.
-                pr *= rxn->FTROE3(T, logpr);
-                kf[j] *= pr;
-                kr[j] *= pr;
-                break;
-            case Troe4: // 4-parameter Troe form.
-                pr *= rxn->FTROE4(T, logpr);
-                kf[j] *= pr;
-                kr[j] *= pr;
-                break;
-            case SRI: // SRI form.
-                pr *= rxn->FSRI(T, logpr);
-                kf[j] *= pr;
-                kr[j] *= pr;
-                break;
-            case Custom: // A custom function is defined to calculate the fall-off form.
-                //rxn->FallOffFn()(*rxn, lowk, tbconcs[j], T, kf[j], kr[j]);
-                throw std::runtime_error("Custom not supported yet.");
-                break;
-            case Lindemann: // F = 1
-                kf[j] *= pr;
-                kr[j] *= pr;
-                break;
-            default:
-                break;
-        }
+            return 0.0;
     }
 }
 
 
 // JACOBIAN EVALUATION.
 
+// Returns true if CalcJacobian evaluates the species and density
+// columns analytically.  The surface, FORD and coverage rate expressions
+// are not differentiated, so mechanisms using them are finite differenced.
+bool ReactionSet::HasAnalyticJacobian() const
+{
+    return m_surface_rxns.empty() && m_ford_rxns.empty() &&
+           m_cov_rxns.empty() && m_stick_rxns.empty();
+}
+
 // Calculates the Jacobian matrix for a constant volume, adiabatic
 // homogeneous mixture. J[j][i] is the Jacobian entry for variable
 // i with respect to i: dFi/dYj.  It is assumed that the Jacobian
@@ -1558,6 +1569,463 @@ void ReactionSet::CalcJacobian(double T, double density, double *const x,
                                const Sprog::Thermo::ThermoInterface &thermo,
                                double pfac, double **J,
                                bool constV, bool constT) const
+{
+    if (HasAnalyticJacobian()) {
+        calcJacobianAnalytic(T, density, x, n, thermo, pfac, J, constV, constT);
+    } else {
+        calcJacobianFD(T, density, x, n, thermo, pfac, J, constV, constT);
+    }
+}
+
+// Calculates the Jacobian matrix with the species and density columns
+// found analytically from the reaction stoichiometry.  The temperature
+// column is found by finite difference.
+void ReactionSet::calcJacobianAnalytic(double T, double density, double *const x,
+                                       unsigned int n,
+                                       const Sprog::Thermo::ThermoInterface &thermo,
+                                       double pfac, double **J,
+                                       bool constV, bool constT) const
+{
+    // Check that we have been given enough species concentrations.
+    if (n < m_mech->Species().size()) return;
+
+    const unsigned int nsp  = m_mech->SpeciesCount();
+    const unsigned int iT   = nsp;
+    const unsigned int iD   = nsp + 1;
+    const unsigned int ngas = m_jac.dnu.size();
+    const double invrho     = 1.0 / density;
+    const fvector &drop = m_wk_jac_drop, &droprho = m_wk_jac_droprho;
+    const fvector &dwtot = m_wk_jac_dwtot, &dS = m_wk_jac_dS;
+    const fvector &xdot = m_wk_jac_xdot, &Cs = m_wk_jac_Cs;
+    unsigned int i, j, k, s;
+
+    double Tdot = 0.0, C = 1.0;
+    const double wtot = calcJacobianTerms(T, density, x, n, thermo, constV, constT, Tdot, C);
+
+    // SPECIES ROWS.
+
+    // Zero the species and density columns.
+    for (k=0; k!=nsp+2; ++k) {
+        if (k == iT) continue;
+        for (i=0; i!=nsp+2; ++i) J[k][i] = 0.0;
+    }
+
+    // Scatter the rate of progress derivatives into the rows of the
+    // species they produce.  J[k][i] holds d(wdot_i)/dx_k for now.
+    for (i=0; i!=nsp; ++i) {
+        const RxnStoichMap &mu = m_mech->GetStoichXRef(i);
+        for (RxnStoichMap::const_iterator im=mu.begin(); im!=mu.end(); ++im) {
+            j = im->first;
+            if (j >= ngas) continue;
+            const double nu = im->second;
+            for (s=m_jac.start[j]; s!=m_jac.start[j+1]; ++s) {
+                J[m_jac.sp[s]][i] += nu * drop[s];
+            }
+            J[iD][i] += nu * droprho[j];
+        }
+    }
+
+    // Convert to the derivatives of dx/dt = (wdot - x * wtot) / density,
+    // and fill in the temperature and density rows.
+    const double tfac = constT ? 0.0 : - T / (density * C);
+    for (k=0; k!=nsp; ++k) {
+        for (i=0; i!=nsp; ++i) {
+            J[k][i] = (J[k][i] - (x[i] * dwtot[k])) * invrho;
+        }
+        J[k][k] -= wtot * invrho;
+
+        const double dTdot = constT ? 0.0 : (tfac * dS[k]) - (Tdot * Cs[k] / C);
+        J[k][iT] = dTdot;
+        if (constV) {
+            J[k][iD] = dwtot[k];
+        } else {
+            // Constant pressure, using the EoS.
+            J[k][iD] = - density * dTdot / T;
+        }
+    }
+
+    // DENSITY COLUMN.
+
+    const double dTdotrho = constT ? 0.0 : (tfac * dS[iD]) - (Tdot * invrho);
+    for (i=0; i!=nsp; ++i) {
+        J[iD][i] = ((J[iD][i] - (x[i] * dwtot[iD])) * invrho) - (xdot[i] * invrho);
+    }
+    J[iD][iT] = dTdotrho;
+    if (constV) {
+        J[iD][iD] = dwtot[iD];
+    } else {
+        J[iD][iD] = - (Tdot + (density * dTdotrho)) / T;
+    }
+
+    // TEMPERATURE COLUMN.
+
+    calcJacobianTColumn(T, density, x, n, thermo, pfac, constV, constT,
+                        wtot, Tdot, J[iT]);
+}
+
+// Returns the sparsity pattern of the species block of the analytic
+// Jacobian.  Species i depends on species k if some reaction producing
+// or consuming i has a rate of progress which depends on k.
+void ReactionSet::JacobianSparsity(std::vector<unsigned int> &start,
+                                   std::vector<unsigned int> &rows) const
+{
+    const unsigned int nsp  = m_mech->SpeciesCount();
+    const unsigned int ngas = m_jac.dnu.size();
+    std::vector<std::vector<unsigned int> > cols(nsp);
+    unsigned int i, k;
+
+    for (i=0; i!=nsp; ++i) {
+        cols[i].push_back(i);
+        const RxnStoichMap &mu = m_mech->GetStoichXRef(i);
+        for (RxnStoichMap::const_iterator im=mu.begin(); im!=mu.end(); ++im) {
+            if ((im->first >= ngas) || (im->second == 0.0)) continue;
+            for (unsigned int s=m_jac.start[im->first]; s!=m_jac.start[im->first+1]; ++s) {
+                cols[m_jac.sp[s]].push_back(i);
+            }
+        }
+    }
+
+    start.assign(1, 0);
+    rows.clear();
+    for (k=0; k!=nsp; ++k) {
+        std::sort(cols[k].begin(), cols[k].end());
+        rows.insert(rows.end(), cols[k].begin(),
+                    std::unique(cols[k].begin(), cols[k].end()));
+        start.push_back(rows.size());
+    }
+}
+
+// Calculates the analytic Jacobian in bordered sparse form.  The
+// pattern of the species block must already be held in J, as returned
+// by JacobianSparsity.
+void ReactionSet::CalcSparseJacobian(double T, double density, double *const x,
+                                     unsigned int n,
+                                     const Sprog::Thermo::ThermoInterface &thermo,
+                                     double pfac, SparseJacobian &J,
+                                     bool constV, bool constT) const
+{
+    // Check that we have been given enough species concentrations.
+    if (n < m_mech->Species().size()) return;
+
+    const unsigned int nsp  = m_mech->SpeciesCount();
+    const unsigned int iT   = nsp;
+    const unsigned int iD   = nsp + 1;
+    const unsigned int ngas = m_jac.dnu.size();
+    const double invrho     = 1.0 / density;
+    const fvector &drop = m_wk_jac_drop, &droprho = m_wk_jac_droprho;
+    const fvector &dwtot = m_wk_jac_dwtot, &dS = m_wk_jac_dS;
+    const fvector &xdot = m_wk_jac_xdot, &Cs = m_wk_jac_Cs;
+    unsigned int i, j, k, s;
+
+    double Tdot = 0.0, C = 1.0;
+    const double wtot = calcJacobianTerms(T, density, x, n, thermo, constV, constT, Tdot, C);
+
+    J.values.assign(J.rows.size(), 0.0);
+    J.u.resize(nsp);
+    J.v.resize(nsp);
+    J.colT.resize(nsp+2);
+    J.colRho.assign(nsp+2, 0.0);
+    J.rowT.resize(nsp);
+    J.rowRho.resize(nsp);
+
+    // Scatter the rate of progress derivatives into the species block.
+    // The rows of each column are sorted, so the entries are found by
+    // bisection.
+    for (i=0; i!=nsp; ++i) {
+        const RxnStoichMap &mu = m_mech->GetStoichXRef(i);
+        for (RxnStoichMap::const_iterator im=mu.begin(); im!=mu.end(); ++im) {
+            j = im->first;
+            if ((j >= ngas) || (im->second == 0.0)) continue;
+            const double nu = im->second;
+            for (s=m_jac.start[j]; s!=m_jac.start[j+1]; ++s) {
+                k = m_jac.sp[s];
+                const unsigned int p = std::lower_bound(J.rows.begin() + J.start[k],
+                                                        J.rows.begin() + J.start[k+1], i)
+                                       - J.rows.begin();
+                J.values[p] += nu * drop[s];
+            }
+            J.colRho[i] += nu * droprho[j];
+        }
+    }
+
+    // Convert to the derivatives of dx/dt = (wdot - x * wtot) / density.
+    // The x * wtot term couples all species, so it is returned as the
+    // outer product u v^T rather than in the sparse block.
+    const double tfac = constT ? 0.0 : - T / (density * C);
+    for (k=0; k!=nsp; ++k) {
+        for (unsigned int p=J.start[k]; p!=J.start[k+1]; ++p) {
+            J.values[p] *= invrho;
+            if (J.rows[p] == k) J.values[p] -= wtot * invrho;
+        }
+        J.u[k] = x[k] * invrho;
+        J.v[k] = dwtot[k];
+
+        const double dTdot = constT ? 0.0 : (tfac * dS[k]) - (Tdot * Cs[k] / C);
+        J.rowT[k] = dTdot;
+        if (constV) {
+            J.rowRho[k] = dwtot[k];
+        } else {
+            // Constant pressure, using the EoS.
+            J.rowRho[k] = - density * dTdot / T;
+        }
+    }
+
+    // Density column.
+    const double dTdotrho = constT ? 0.0 : (tfac * dS[iD]) - (Tdot * invrho);
+    for (i=0; i!=nsp; ++i) {
+        J.colRho[i] = ((J.colRho[i] - (x[i] * dwtot[iD])) * invrho) - (xdot[i] * invrho);
+    }
+    J.colRho[iT] = dTdotrho;
+    if (constV) {
+        J.colRho[iD] = dwtot[iD];
+    } else {
+        J.colRho[iD] = - (Tdot + (density * dTdotrho)) / T;
+    }
+
+    // Temperature column.
+    calcJacobianTColumn(T, density, x, n, thermo, pfac, constV, constT,
+                        wtot, Tdot, &J.colT[0]);
+}
+
+// Calculates the rates of progress of the gas-phase reactions and their
+// derivatives w.r.t. the species mole fractions and density, as used by
+// the analytic Jacobians.  The rate of progress of reaction j is
+//     rop_j = F_j(M) * (kf_j * prod(c_reac) - kr_j * prod(c_prod)),
+// where c = density * x, and F_j collects the third-body and fall-off
+// factors, which depend on the species only through the third-body
+// concentration M.  The derivatives of rop_j are held against the slots
+// of the Jacobian pattern, and the derivatives of the total production
+// rate and of sum(wdot * H) are found from the net change of each
+// reaction.  Returns the total molar production rate; the results are
+// left in the m_wk_jac workspace.
+double ReactionSet::calcJacobianTerms(double T, double density, const double *const x,
+                                      unsigned int n,
+                                      const Sprog::Thermo::ThermoInterface &thermo,
+                                      bool constV, bool constT,
+                                      double &Tdot, double &C) const
+{
+    const unsigned int nsp  = m_mech->SpeciesCount();
+    const unsigned int iD   = nsp + 1;
+    const unsigned int ngas = m_jac.dnu.size();
+    const double invrho     = 1.0 / density;
+    unsigned int i, j, k, s;
+
+    // SETUP WORKSPACE.
+
+    fvector &kf = m_wk_kf, &kr = m_wk_kr, &Gs = m_wk_Gs, &tbconcs = m_wk_tbconcs;
+    fvector &rop = m_wk_rop, &rfwd = m_wk_rfwd, &rrev = m_wk_rrev, &c = m_wk_conc;
+    fvector &M = m_wk_jac_M, &dlnk = m_wk_jac_dlnk, &drop = m_wk_jac_drop;
+    fvector &droprho = m_wk_jac_droprho, &dH = m_wk_jac_dH;
+    fvector &dwtot = m_wk_jac_dwtot, &dS = m_wk_jac_dS;
+    fvector &wdot = m_wk_jac_wdot, &xdot = m_wk_jac_xdot;
+    fvector &Hs = m_wk_jac_Hs, &Cs = m_wk_jac_Cs;
+
+    kf.resize(m_rxns.size(), 0.0);
+    kr.resize(m_rxns.size(), 0.0);
+    tbconcs.resize(m_rxns.size(), 0.0);
+    Gs.resize(nsp, 0.0);
+    dlnk.assign(m_rxns.size(), 0.0);
+    drop.assign(m_jac.sp.size(), 0.0);
+    droprho.assign(ngas, 0.0);
+    dH.assign(ngas, 0.0);
+    dwtot.assign(nsp+2, 0.0);
+    dS.assign(nsp+2, 0.0);
+    xdot.resize(nsp, 0.0);
+    Hs.assign(nsp, 0.0);
+
+    // CALCULATE UNPERTURBED VALUES.
+
+    // Rate constants, keeping the third-body concentrations as they
+    // are before the fall-off terms reset them.
+    thermo.CalcGs_RT(T, Gs);
+    calcRateConstantsT(T, Gs, kf, kr);
+    calcTB_Concs(density, x, n, tbconcs);
+    M = tbconcs;
+    calcFallOffTerms(T, density, x, n, tbconcs, kf, kr, &dlnk);
+    for (RxnMap::const_iterator im=m_tb_rxns.begin(); im!=m_tb_rxns.end(); ++im) {
+        kf[*im] *= tbconcs[*im];
+        kr[*im] *= tbconcs[*im];
+    }
+
+    // Rates of progress and molar production rates.
+    GetRatesOfProgress(density, x, n, kf, kr, rop, rfwd, rrev);
+    const double wtot = GetMolarProdRates(rop, wdot);
+
+    for (i=0; i!=nsp; ++i) {
+        xdot[i] = (wdot[i] - (x[i]*wtot)) * invrho;
+    }
+
+    // Temperature term dT/dt, and the bulk and species heat capacities.
+    Tdot = 0.0;
+    C    = 1.0;
+    if (!constT) {
+        if (constV) {
+            // Use internal energies for constant volume.
+            thermo.CalcUs_RT(T, Hs);
+            C = thermo.CalcBulkCv_R(T, x, n, Cs);
+        } else {
+            // Use enthalpies for constant pressure.
+            thermo.CalcHs_RT(T, Hs);
+            C = thermo.CalcBulkCp_R(T, x, n, Cs);
+        }
+        for (i=0; i!=nsp; ++i) {
+            Tdot += wdot[i] * Hs[i];
+        }
+        Tdot *= - T / (density * C);
+
+        // Enthalpy change of each reaction.
+        for (i=0; i!=nsp; ++i) {
+            const RxnStoichMap &mu = m_mech->GetStoichXRef(i);
+            for (RxnStoichMap::const_iterator im=mu.begin(); im!=mu.end(); ++im) {
+                if (im->first < ngas) dH[im->first] += im->second * Hs[i];
+            }
+        }
+    }
+
+    // RATE OF PROGRESS DERIVATIVES.
+
+    c.resize(n);
+    for (k=0; k!=n; ++k) {
+        c[k] = density * x[k];
+    }
+
+    for (j=0; j!=ngas; ++j) {
+        // Mass action terms.  Each factor contributes the rate constant
+        // times density times the product of the other factors.
+        for (unsigned int p=m_jac.fstart[j]; p!=m_jac.fstart[j+1]; ++p) {
+            double d = kf[j] * density;
+            for (unsigned int q=m_jac.fstart[j]; q!=m_jac.fstart[j+1]; ++q) {
+                if (q != p) d *= c[m_jac.sp[m_jac.fslot[q]]];
+            }
+            drop[m_jac.fslot[p]] += d;
+        }
+        for (unsigned int p=m_jac.rstart[j]; p!=m_jac.rstart[j+1]; ++p) {
+            double d = kr[j] * density;
+            for (unsigned int q=m_jac.rstart[j]; q!=m_jac.rstart[j+1]; ++q) {
+                if (q != p) d *= c[m_jac.sp[m_jac.rslot[q]]];
+            }
+            drop[m_jac.rslot[p]] -= d;
+        }
+        droprho[j] = (((m_jac.fstart[j+1] - m_jac.fstart[j]) * rfwd[j]) -
+                      ((m_jac.rstart[j+1] - m_jac.rstart[j]) * rrev[j])) * invrho;
+
+        // Third-body terms.  The third-body factor is M itself, unless
+        // M enters through the fall-off reduced pressure.
+        double g = 0.0;
+        if (M[j] > 0.0) {
+            if (m_jac.foslot[j] == -1) {
+                g = rop[j] * dlnk[j] / M[j];
+            } else if (m_jac.usetb[j]) {
+                g = rop[j] / M[j];
+            }
+        }
+        if (g != 0.0) {
+            for (unsigned int t=m_jac.tbstart[j]; t!=m_jac.tbstart[j+1]; ++t) {
+                drop[m_jac.tbslot[t]] += g * density * m_jac.tbcoeff[t];
+            }
+            droprho[j] += g * M[j] * invrho;
+        }
+
+        // Fall-off reactions with a particular third-body species.
+        if (m_jac.foslot[j] >= 0) {
+            s = m_jac.foslot[j];
+            const double Ms = c[m_jac.sp[s]];
+            if (Ms > 0.0) {
+                g = rop[j] * dlnk[j] / Ms;
+                drop[s] += g * density;
+                droprho[j] += g * x[m_jac.sp[s]];
+            }
+        }
+
+        // Derivatives of the total molar production rate and
+        // of sum(wdot * H).
+        for (s=m_jac.start[j]; s!=m_jac.start[j+1]; ++s) {
+            dwtot[m_jac.sp[s]] += m_jac.dnu[j] * drop[s];
+            dS[m_jac.sp[s]]    += dH[j] * drop[s];
+        }
+        dwtot[iD] += m_jac.dnu[j] * droprho[j];
+        dS[iD]    += dH[j] * droprho[j];
+    }
+
+    return wtot;
+}
+
+// Calculates the temperature column of the Jacobian by finite difference.
+// The unperturbed total production rate and dT/dt are given, and the
+// unperturbed dx/dt must be in the m_wk_jac_xdot workspace.
+void ReactionSet::calcJacobianTColumn(double T, double density, const double *const x,
+                                      unsigned int n,
+                                      const Sprog::Thermo::ThermoInterface &thermo,
+                                      double pfac, bool constV, bool constT,
+                                      double wtot, double Tdot, double *col) const
+{
+    const unsigned int nsp = m_mech->SpeciesCount();
+    const unsigned int iT  = nsp;
+    const unsigned int iD  = nsp + 1;
+    const double invrho    = 1.0 / density;
+    fvector &kf = m_wk_kf, &kr = m_wk_kr, &Gs = m_wk_Gs, &tbconcs = m_wk_tbconcs;
+    fvector &rop = m_wk_rop, &wdot = m_wk_jac_wdot, &Hs = m_wk_jac_Hs;
+    const fvector &xdot = m_wk_jac_xdot;
+    unsigned int i;
+
+    // Perturb temperature.
+    const double dT = sqrt(pfac) * abs(T);
+    const double invdT = 1.0 / dT;
+    const double Tpert = T + dT;
+
+    // Recalculate all rate constants.
+    thermo.CalcGs_RT(Tpert, Gs);
+    calcRateConstantsT(Tpert, Gs, kf, kr);
+    calcTB_Concs(density, x, n, tbconcs);
+    calcFallOffTerms(Tpert, density, x, n, tbconcs, kf, kr);
+    for (RxnMap::const_iterator im=m_tb_rxns.begin(); im!=m_tb_rxns.end(); ++im) {
+        kf[*im] *= tbconcs[*im];
+        kr[*im] *= tbconcs[*im];
+    }
+
+    // Recalculate reaction rates-of-progress and molar
+    // production rates of species.
+    GetRatesOfProgress(density, x, n, kf, kr, rop, m_wk_rfwd, m_wk_rrev);
+    const double wtot1 = GetMolarProdRates(rop, wdot);
+
+    // Calculate Jacobian entries for species mole fractions.
+    for (i=0; i!=nsp; ++i) {
+        col[i] = ((((wdot[i] - (x[i]*wtot1)) * invrho) - xdot[i]) * invdT);
+    }
+
+    // Calculate temperature term dT/dt.
+    double Tdot1 = 0.0;
+    if (!constT) {
+        double C1;
+        if (constV) {
+            thermo.CalcUs_RT(Tpert, Hs);
+            C1 = thermo.CalcBulkCv_R(Tpert, x, n);
+        } else {
+            thermo.CalcHs_RT(Tpert, Hs);
+            C1 = thermo.CalcBulkCp_R(Tpert, x, n);
+        }
+        for (i=0; i!=nsp; ++i) {
+            Tdot1 += wdot[i] * Hs[i];
+        }
+        Tdot1 *= - Tpert / (density * C1);
+    }
+    col[iT] = (Tdot1 - Tdot) * invdT;
+
+    // Calculate density Jacobian entry.
+    if (constV) {
+        col[iD] = (wtot1 - wtot) * invdT;
+    } else {
+        col[iD] = - density * (col[iT] - (Tdot / T)) / T;
+    }
+}
+
+// Calculates the Jacobian matrix entirely by finite differences.  This
+// is used for mechanisms with surface, FORD or coverage reactions.
+void ReactionSet::calcJacobianFD(double T, double density, double *const x,
+                                 unsigned int n,
+                                 const Sprog::Thermo::ThermoInterface &thermo,
+                                 double pfac, double **J,
+                                 bool constV, bool constT) const
 {
     bool fallocated=false;
     fvector tbconcs, kfT, krT, kf, kr, Gs, rop0,
@@ -1660,6 +2128,10 @@ void ReactionSet::CalcJacobian(double T, double density, double *const x,
 
     // FINITE DIFFERENCING W.R.T. SPECIES MOLE FRACTIONS.
 
+    // Reactions whose third-body terms depend on each species.
+    std::vector<unsigned int> tbstart, tbrxns, mark(m_rxns.size(), 0);
+    thirdBodyDependents(tbstart, tbrxns);
+
     dx = 0.0; invdx=0.0;
     for (unsigned int k=0; k!=m_mech->SpeciesCount(); ++k) {
         // PERTURB VARIABLE.
@@ -1671,52 +2143,13 @@ void ReactionSet::CalcJacobian(double T, double density, double *const x,
         invdx = 1.0 / dx;
         x[k] += dx;
 
-        // RECALCULATE RATE EXPRESSIONS.
-
-        // Copy back in the concentration-independent parts of
-        // the rate constant expressions.
-        memcpy(&kf[0], &kfT[0], sizeof(double)*m_rxns.size());
-        memcpy(&kr[0], &krT[0], sizeof(double)*m_rxns.size());
-
-        // Calculate concentration-dependent terms.
-        // TODO:  Optimise this to only calculate for affected reactions.
-        calcTB_Concs(density, x, n, tbconcs);
-        calcFallOffTerms(T, density, x, n, tbconcs, kf, kr);
-        for (RxnMap::const_iterator i=m_tb_rxns.begin(); i!=m_tb_rxns.end(); ++i) {
-            unsigned int j = *i;
-            kf[j] *= tbconcs[j];
-            kr[j] *= tbconcs[j];
-        }
-
-        // RECALCULATE RATES-OF-PROGRESS.
-
-        // Copy unperturbed values.
-        memcpy(&rop1[0], &rop0[0], sizeof(double)*m_rxns.size());
-        // memcpy(&wdot1[0], &wdot0[0], sizeof(double)*m_mech->SpeciesCount());
-
-        // Recalculate third-body and fall-off reaction rates-of-progress.
-        for (RxnMap::const_iterator i=m_tb_rxns.begin(); i!=m_tb_rxns.end(); ++i) {
-            unsigned int j = *i;
-            rop1[j] = m_rxns[j]->RateOfProgress(density, x, n, kf[j], kr[j]);
-        }
-        for (RxnMap::const_iterator i=m_fo_rxns.begin(); i!=m_fo_rxns.end(); ++i) {
-            unsigned int j = *i;
-            rop1[j] = m_rxns[j]->RateOfProgress(density, x, n, kf[j], kr[j]);
-        }
-
-        // Recalculate other reaction rates-of-progress for which
-        // the kth species is a reactant.
-        const RxnStoichMap &mu = m_mech->GetStoichXRef(k);
-        for (RxnStoichMap::const_iterator i=mu.begin(); i!=mu.end(); ++i) {
-            unsigned int j = i->first;
-            rop1[j] = m_rxns[j]->RateOfProgress(density, x, n, kf[j], kr[j]);
-        }
-
         // RECALCULATE MOLAR PRODUCTION RATES.
 
-        // Calculate perturbed molar production rates.
-        // TODO:  Can this be optimised to avoid looping over all species?
-        wtot1 = GetMolarProdRates(rop1, wdot1);
+        // Only the reactions which depend on species k are evaluated,
+        // and their changes are added to the unperturbed production rates.
+        memcpy(&wdot1[0], &wdot0[0], sizeof(double)*m_mech->SpeciesCount());
+        wtot1 = wtot0 + calcPerturbedRates(k, T, density, x, n, kfT, krT, rop0,
+                                           tbstart, tbrxns, mark, wdot1);
 
         // Calculate dx/dt.
         for (unsigned int i=0; i!=m_mech->SpeciesCount(); ++i) {
@@ -1886,6 +2319,111 @@ void ReactionSet::CalcJacobian(double T, double density, double *const x,
     }
 }
 
+// Finds, for each species, the reactions whose third-body concentration
+// or fall-off reduced pressure depend on its mole fraction.  This is the
+// transpose of the packed third-body efficiency matrix together with the
+// fall-off reactions which name a particular third body.
+void ReactionSet::thirdBodyDependents(std::vector<unsigned int> &start,
+                                      std::vector<unsigned int> &rxns) const
+{
+    const unsigned int nsp = m_mech->SpeciesCount();
+
+    // Count the reactions of each species.
+    start.assign(nsp+1, 0);
+    for (unsigned int p=0; p!=m_tb_sp.size(); ++p) {
+        ++start[m_tb_sp[p]+1];
+    }
+    for (unsigned int f=0; f!=m_fo_tb.size(); ++f) {
+        if (m_fo_tb[f] >= 0) ++start[m_fo_tb[f]+1];
+    }
+    for (unsigned int k=0; k!=nsp; ++k) {
+        start[k+1] += start[k];
+    }
+
+    // Fill in the reactions.
+    std::vector<unsigned int> pos(start.begin(), start.end() - 1);
+    rxns.resize(start[nsp]);
+    for (unsigned int j=0; j+1<m_tb_start.size(); ++j) {
+        for (unsigned int p=m_tb_start[j]; p!=m_tb_start[j+1]; ++p) {
+            rxns[pos[m_tb_sp[p]]++] = j;
+        }
+    }
+    for (unsigned int f=0; f!=m_fo_tb.size(); ++f) {
+        if (m_fo_tb[f] >= 0) rxns[pos[m_fo_tb[f]]++] = m_fo_index[f];
+    }
+}
+
+// Recalculates the rates of progress of the reactions which depend on
+// the perturbed mole fraction of species k and adds the changes in the
+// molar production rates to wdot.  The rate constants are built up from
+// the concentration-independent parts in the same way as in
+// calcJacobianFD(), but for the affected reactions only.  As in
+// GetMolarProdRates() only the gas-phase reactions contribute to wdot.
+double ReactionSet::calcPerturbedRates(unsigned int k, double T, double density,
+                                       const double *const x, unsigned int n,
+                                       const fvector &kfT, const fvector &krT,
+                                       const fvector &rop0,
+                                       const std::vector<unsigned int> &tbstart,
+                                       const std::vector<unsigned int> &tbrxns,
+                                       std::vector<unsigned int> &mark,
+                                       fvector &wdot) const
+{
+    const unsigned int size_gas_rxns = m_rxns.size() - m_surface_rxns.size();
+    const double invRT = calcInvRT(T);
+    const RxnStoichMap &mu = m_mech->GetStoichXRef(k);
+    RxnStoichMap::const_iterator im = mu.begin();
+    unsigned int it = tbstart[k];
+    double kf=0.0, kr=0.0, tbconc=0.0, sum=0.0, d=0.0, dwtot=0.0;
+
+    // Visit the reactions of species k, then its third-body dependents.
+    // mark holds k+1 for reactions already done for this species.  The
+    // surface reactions do not contribute to wdot, so are skipped.
+    while ((im != mu.end()) || (it != tbstart[k+1])) {
+        unsigned int j;
+        if (im != mu.end()) {
+            j = (im++)->first;
+        } else {
+            j = tbrxns[it++];
+        }
+        if ((mark[j] == k+1) || (j >= size_gas_rxns)) continue;
+        mark[j] = k+1;
+
+        // Rate constants with third-body and fall-off terms.
+        kf = kfT[j];
+        kr = krT[j];
+        tbconc = density;
+        if (m_tb_use[j]) {
+            sum = 0.0;
+            for (unsigned int p=m_tb_start[j]; p!=m_tb_start[j+1]; ++p) {
+                sum += m_tb_coeff[p] * x[m_tb_sp[p]];
+            }
+            tbconc = density * (1.0 + sum);
+        }
+        if (m_fo_pos[j] >= 0) {
+            d = calcFallOffFactor(m_fo_pos[j], T, invRT, density, x, kf, tbconc, NULL);
+            kf *= d;
+            kr *= d;
+        }
+        if (m_tb_use[j]) {
+            kf *= tbconc;
+            kr *= tbconc;
+        }
+
+        // Change in the rate of progress, scattered into the species
+        // through the packed reactant and product factors.
+        d = m_rxns[j]->RateOfProgress(density, x, n, kf, kr) - rop0[j];
+        for (unsigned int p=m_jac.fstart[j]; p!=m_jac.fstart[j+1]; ++p) {
+            wdot[m_jac.sp[m_jac.fslot[p]]] -= d;
+        }
+        for (unsigned int p=m_jac.rstart[j]; p!=m_jac.rstart[j+1]; ++p) {
+            wdot[m_jac.sp[m_jac.rslot[p]]] += d;
+        }
+        dwtot += d * m_jac.dnu[j];
+    }
+
+    return dwtot;
+}
+
 /*!
 The Jacobian matrix is originally calculated for [dOmegai/dxj]/rho
 For LOI it is needed to be [dOmegai/dCj], therefore a change of basis by
@@ -2003,6 +2541,10 @@ void ReactionSet::RateJacobian(
 
     // FINITE DIFFERENCING W.R.T. SPECIES MOLE CONCENTRATIONS.
 
+    // Reactions whose third-body terms depend on each species.
+    std::vector<unsigned int> tbstart, tbrxns, mark(m_rxns.size(), 0);
+    thirdBodyDependents(tbstart, tbrxns);
+
     dconc = 0.0; invdconc=0.0;
     for (unsigned int k=0; k!=m_mech->SpeciesCount(); ++k) {
         // PERTURB VARIABLE.
@@ -2013,52 +2555,13 @@ void ReactionSet::RateJacobian(
         invdconc = 1.0 / dconc;
         x[k] += dconc;
 
-        // RECALCULATE RATE EXPRESSIONS.
-
-        // Copy back in the concentration-independent parts of
-        // the rate constant expressions.
-        memcpy(&kf[0], &kfT[0], sizeof(double)*m_rxns.size());
-        memcpy(&kr[0], &krT[0], sizeof(double)*m_rxns.size());
-
-        // Calculate concentration-dependent terms.
-        // TODO:  Optimise this to only calculate for affected reactions.
-        calcTB_Concs(density, x, n, tbconcs);
-        calcFallOffTerms(T, density, x, n, tbconcs, kf, kr);
-        for (RxnMap::const_iterator i=m_tb_rxns.begin(); i!=m_tb_rxns.end(); ++i) {
-            unsigned int j = *i;
-            kf[j] *= tbconcs[j];
-            kr[j] *= tbconcs[j];
-        }
-
-        // RECALCULATE RATES-OF-PROGRESS.
-
-        // Copy unperturbed values.
-        memcpy(&rop1[0], &rop0[0], sizeof(double)*m_rxns.size());
-        // memcpy(&wdot1[0], &wdot0[0], sizeof(double)*m_mech->SpeciesCount());
-
-        // Recalculate third-body and fall-off reaction rates-of-progress.
-        for (RxnMap::const_iterator i=m_tb_rxns.begin(); i!=m_tb_rxns.end(); ++i) {
-            unsigned int j = *i;
-            rop1[j] = m_rxns[j]->RateOfProgress(density, x, n, kf[j], kr[j]);
-        }
-        for (RxnMap::const_iterator i=m_fo_rxns.begin(); i!=m_fo_rxns.end(); ++i) {
-            unsigned int j = *i;
-            rop1[j] = m_rxns[j]->RateOfProgress(density, x, n, kf[j], kr[j]);
-        }
-
-        // Recalculate other reaction rates-of-progress for which
-        // the kth species is a reactant.
-        const RxnStoichMap &mu = m_mech->GetStoichXRef(k);
-        for (RxnStoichMap::const_iterator i=mu.begin(); i!=mu.end(); ++i) {
-            unsigned int j = i->first;
-            rop1[j] = m_rxns[j]->RateOfProgress(density, x, n, kf[j], kr[j]);
-        }
-
         // RECALCULATE MOLAR PRODUCTION RATES.
 
-        // Calculate perturbed molar production rates.
-        // TODO:  Can this be optimised to avoid looping over all species?
-        GetMolarProdRates(rop1, wdot1);
+        // Only the reactions which depend on species k are evaluated,
+        // and their changes are added to the unperturbed production rates.
+        memcpy(&wdot1[0], &wdot0[0], sizeof(double)*m_mech->SpeciesCount());
+        calcPerturbedRates(k, T, density, x, n, kfT, krT, rop0,
+                           tbstart, tbrxns, mark, wdot1);
 
         // Calculate temperature term dT/dt.
         Tdot1 = 0.0;
@@ -2240,6 +2743,15 @@ void ReactionSet::releaseMemory()
     m_cov_rxns.clear();
     m_stick_rxns.clear();
     m_mottw_rxns.clear();
+    m_packed_fwd.Clear();
+    m_packed_rev.Clear();
+    m_jac.Clear();
+    m_arr_A.clear(); m_arr_n.clear(); m_arr_E.clear();
+    m_revarr_A.clear(); m_revarr_n.clear(); m_revarr_E.clear();
+    m_eq_rxns.clear();
+    m_trange_rxns.clear();
+    m_trange_min.clear(); m_trange_max.clear();
+    clearThirdBodies();
 
     // Delete the reactions.
     RxnPtrVector::iterator i;
@@ -2249,6 +2761,282 @@ void ReactionSet::releaseMemory()
     m_rxns.clear();
 }
 
+// Rebuilds the packed rate data.  This must be called after reactions
+// in the set have been modified in place.
+void ReactionSet::Update()
+{
+    pack();
+}
+
+// Rebuilds all packed rate data.  As in the rate of progress calculation
+// the gas-phase reactions are taken to be the first
+// m_rxns.size() - m_surface_rxns.size() reactions.
+void ReactionSet::pack()
+{
+    m_packed_fwd.Clear();
+    m_packed_rev.Clear();
+    m_jac.Clear();
+    m_arr_A.clear(); m_arr_n.clear(); m_arr_E.clear();
+    m_revarr_A.clear(); m_revarr_n.clear(); m_revarr_E.clear();
+    m_eq_rxns.clear();
+    m_trange_rxns.clear();
+    m_trange_min.clear(); m_trange_max.clear();
+    clearThirdBodies();
+
+    const unsigned int size_gas_rxns = m_rxns.size() - m_surface_rxns.size();
+    for (unsigned int i=0; i!=size_gas_rxns; ++i) {
+        packReaction(i);
+    }
+    for (unsigned int i=0; i!=m_rxns.size(); ++i) {
+        packArrhenius(i);
+        packThirdBodies(i);
+    }
+}
+
+// Adds reaction i to the packed Arrhenius and temperature range data.
+void ReactionSet::packArrhenius(unsigned int i)
+{
+    const Reaction &rxn = *m_rxns[i];
+
+    m_arr_A.push_back(rxn.Arrhenius().A);
+    m_arr_n.push_back(rxn.Arrhenius().n);
+    m_arr_E.push_back(rxn.Arrhenius().E);
+
+    // Explicit reverse parameters follow the order of m_rev_rxns.
+    if (rxn.RevArrhenius() != NULL) {
+        m_revarr_A.push_back(rxn.RevArrhenius()->A);
+        m_revarr_n.push_back(rxn.RevArrhenius()->n);
+        m_revarr_E.push_back(rxn.RevArrhenius()->E);
+    } else if (rxn.IsReversible()) {
+        m_eq_rxns.push_back(i);
+    }
+
+    if (rxn.HasTemperatureRange()) {
+        m_trange_rxns.push_back(i);
+        m_trange_min.push_back(rxn.MinTemperature());
+        m_trange_max.push_back(rxn.MaxTemperature());
+    }
+}
+
+// Adds reaction i to the packed third-body efficiency matrix and, if it
+// is a fall-off reaction, to the packed fall-off parameters.
+void ReactionSet::packThirdBodies(unsigned int i)
+{
+    const Reaction &rxn = *m_rxns[i];
+
+    // Enhanced third bodies.  Species with unit efficiency do not change
+    // the third-body concentration from its default, so are not stored.
+    if (m_tb_start.empty()) m_tb_start.push_back(0);
+    m_tb_use.push_back(rxn.UseThirdBody());
+    if (rxn.UseThirdBody()) {
+        for (int k=0; k!=rxn.ThirdBodyCount(); ++k) {
+            const double coeff = rxn.ThirdBody(k).Mu() - 1.0;
+            if (coeff != 0.0) {
+                m_tb_sp.push_back(rxn.ThirdBody(k).Index());
+                m_tb_coeff.push_back(coeff);
+            }
+        }
+    }
+    m_tb_start.push_back(m_tb_sp.size());
+
+    // Fall-off parameters.
+    if (rxn.FallOffType() == None) {
+        m_fo_pos.push_back(-1);
+    } else {
+        const FALLOFF_PARAMS &fo = rxn.FallOffParams();
+        m_fo_pos.push_back(m_fo_index.size());
+        m_fo_index.push_back(i);
+        m_fo_type.push_back(rxn.FallOffType());
+        m_fo_A.push_back(fo.LowP_Limit.A);
+        m_fo_n.push_back(fo.LowP_Limit.n);
+        m_fo_E.push_back(fo.LowP_Limit.E);
+        m_fo_tb.push_back(fo.ThirdBody);
+        m_fo_params.insert(m_fo_params.end(), fo.Params,
+                           fo.Params + FALLOFF_PARAMS::MAX_FALLOFF_PARAMS);
+    }
+}
+
+// Removes all reactions from the packed third-body and fall-off data.
+void ReactionSet::clearThirdBodies()
+{
+    m_tb_start.clear(); m_tb_sp.clear(); m_tb_coeff.clear(); m_tb_use.clear();
+    m_fo_index.clear(); m_fo_type.clear();
+    m_fo_A.clear(); m_fo_n.clear(); m_fo_E.clear();
+    m_fo_tb.clear(); m_fo_params.clear(); m_fo_pos.clear();
+}
+
+// Adds reaction i to the packed products.
+void ReactionSet::packReaction(unsigned int i)
+{
+    std::vector<unsigned int> sp;
+    int j, k;
+
+    // Reactants, repeated according to their stoichiometry.
+    for (k=0; k!=m_rxns[i]->ReactantCount(); ++k) {
+        for (j=0; j!=m_rxns[i]->Reactants()[k].Mu(); ++j) {
+            sp.push_back(m_rxns[i]->Reactants()[k].Index());
+        }
+    }
+    m_packed_fwd.Add(i, sp);
+
+    // Products, repeated according to their stoichiometry.
+    sp.clear();
+    for (k=0; k!=m_rxns[i]->ProductCount(); ++k) {
+        for (j=0; j!=m_rxns[i]->Products()[k].Mu(); ++j) {
+            sp.push_back(m_rxns[i]->Products()[k].Index());
+        }
+    }
+    m_packed_rev.Add(i, sp);
+
+    packJacobian(i);
+}
+
+// Adds reaction i to the Jacobian pattern.
+void ReactionSet::packJacobian(unsigned int i)
+{
+    const Reaction &rxn = *m_rxns[i];
+    double dnu = 0.0;
+    int j, k;
+
+    if (m_jac.start.empty()) {
+        m_jac.start.push_back(0);
+        m_jac.fstart.push_back(0);
+        m_jac.rstart.push_back(0);
+        m_jac.tbstart.push_back(0);
+    }
+
+    // Reactant and product factors, repeated according to stoichiometry.
+    for (k=0; k!=rxn.ReactantCount(); ++k) {
+        for (j=0; j!=rxn.Reactants()[k].Mu(); ++j) {
+            m_jac.fslot.push_back(m_jac.Slot(rxn.Reactants()[k].Index()));
+        }
+        dnu -= rxn.Reactants()[k].Mu();
+    }
+    for (k=0; k!=rxn.ProductCount(); ++k) {
+        for (j=0; j!=rxn.Products()[k].Mu(); ++j) {
+            m_jac.rslot.push_back(m_jac.Slot(rxn.Products()[k].Index()));
+        }
+        dnu += rxn.Products()[k].Mu();
+    }
+
+    // Enhanced third bodies.  Species with unit efficiency do not change
+    // the third-body concentration from its default.
+    m_jac.usetb.push_back(rxn.UseThirdBody());
+    if (rxn.UseThirdBody()) {
+        for (k=0; k!=rxn.ThirdBodyCount(); ++k) {
+            const double coeff = rxn.ThirdBody(k).Mu() - 1.0;
+            if (coeff != 0.0) {
+                m_jac.tbslot.push_back(m_jac.Slot(rxn.ThirdBody(k).Index()));
+                m_jac.tbcoeff.push_back(coeff);
+            }
+        }
+    }
+
+    // Fall-off third body.
+    if (rxn.FallOffType() == None) {
+        m_jac.foslot.push_back(-2);
+    } else if (rxn.FallOffParams().ThirdBody >= 0) {
+        m_jac.foslot.push_back(m_jac.Slot(rxn.FallOffParams().ThirdBody));
+    } else {
+        m_jac.foslot.push_back(-1);
+    }
+
+    m_jac.dnu.push_back(dnu);
+    m_jac.start.push_back(m_jac.sp.size());
+    m_jac.fstart.push_back(m_jac.fslot.size());
+    m_jac.rstart.push_back(m_jac.rslot.size());
+    m_jac.tbstart.push_back(m_jac.tbslot.size());
+}
+
+// Removes all reactions from the Jacobian pattern.
+void ReactionSet::JacobianPattern::Clear()
+{
+    start.clear(); sp.clear();
+    fstart.clear(); fslot.clear();
+    rstart.clear(); rslot.clear();
+    tbstart.clear(); tbslot.clear(); tbcoeff.clear();
+    usetb.clear(); foslot.clear(); dnu.clear();
+}
+
+// Returns the slot of species k in the reaction being added,
+// adding a new slot if the species has none yet.
+unsigned int ReactionSet::JacobianPattern::Slot(unsigned int k)
+{
+    for (unsigned int s=start.back(); s!=sp.size(); ++s) {
+        if (sp[s] == k) return s;
+    }
+    sp.push_back(k);
+    return sp.size() - 1;
+}
+
+// Removes all reactions from the packed products.
+void ReactionSet::PackedSide::Clear()
+{
+    rxns1.clear(); rxns2.clear(); rxns3.clear(); rxnsn.clear();
+    sp1.clear(); sp2.clear(); sp3.clear(); spn.clear();
+    startn.clear();
+}
+
+// Adds reaction i with the given factor species to the packed products.
+// Reactions without factors need no entry.
+void ReactionSet::PackedSide::Add(unsigned int i, const std::vector<unsigned int> &sp)
+{
+    switch (sp.size()) {
+        case 0:
+            break;
+        case 1:
+            rxns1.push_back(i);
+            sp1.push_back(sp[0]);
+            break;
+        case 2:
+            rxns2.push_back(i);
+            sp2.insert(sp2.end(), sp.begin(), sp.end());
+            break;
+        case 3:
+            rxns3.push_back(i);
+            sp3.insert(sp3.end(), sp.begin(), sp.end());
+            break;
+        default:
+            if (startn.empty()) startn.push_back(0);
+            rxnsn.push_back(i);
+            spn.insert(spn.end(), sp.begin(), sp.end());
+            startn.push_back(spn.size());
+            break;
+    }
+}
+
+// Multiplies each packed r[i] by the product of its factor concentrations.
+// The factors are applied in stoichiometric order, so the results are
+// identical to multiplying the rate constant by one concentration at a time.
+void ReactionSet::PackedSide::Multiply(const fvector &c, fvector &r) const
+{
+    const unsigned int n1 = rxns1.size();
+    for (unsigned int j=0; j!=n1; ++j) {
+        r[rxns1[j]] *= c[sp1[j]];
+    }
+
+    const unsigned int n2 = rxns2.size();
+    for (unsigned int j=0; j!=n2; ++j) {
+        const unsigned int *s = &sp2[2*j];
+        r[rxns2[j]] = r[rxns2[j]] * c[s[0]] * c[s[1]];
+    }
+
+    const unsigned int n3 = rxns3.size();
+    for (unsigned int j=0; j!=n3; ++j) {
+        const unsigned int *s = &sp3[3*j];
+        r[rxns3[j]] = r[rxns3[j]] * c[s[0]] * c[s[1]] * c[s[2]];
+    }
+
+    const unsigned int nn = rxnsn.size();
+    for (unsigned int j=0; j!=nn; ++j) {
+        double rr = r[rxnsn[j]];
+        for (unsigned int l=startn[j]; l!=startn[j+1]; ++l) {
+            rr *= c[spn[l]];
+        }
+        r[rxnsn[j]] = rr;
+    }
+}
+
 // Writes the reaction set to a binary data stream.
 void ReactionSet::Serialize(std::ostream &out) const
 {
@@ -2576,6 +3364,9 @@ void ReactionSet::Deserialize(std::istream &in)
                     m_mottw_rxns[i] = ix;
                 }
 
+                // Build packed rate data.
+                pack();
+
                 break;
             default:
                 throw runtime_error("Serialized version number is unsupported (Sprog, ReactionSet::Deserialize).");
@@ -424,7 +424,44 @@ protected:
         double r1,                //!< Radius of sphere 1.
         const Coords::Vector &p2, //!< Positional vector of sphere 2.
         double r2,                //!< Radius of sphere 2.
-        double &Separation        //!< Separation between the centres of the primary particles for use with the Newton bisection method.   
+        double &Separation        //!< Separation between the centres of the primary particles for use with the Newton bisection method.
+        );
+
+    //! Node of the bounding-sphere hierarchy used to find the first contact.
+    struct CollisionSphere {
+        Coords::Vector centre;  //!< Centre of the sphere enclosing the node.
+        double radius;          //!< Radius of the sphere enclosing the node.
+        int left;               //!< Index of the left child, -1 for a leaf.
+        int right;              //!< Index of the right child, -1 for a leaf.
+        BinTreePrimary *leaf;   //!< Primary of a leaf, NULL otherwise.
+    };
+
+    //! Builds the bounding-sphere hierarchy of a node, returns its index.
+    static int buildCollisionTree(
+        BinTreePrimary &node,                 //!< Root of the hierarchy.
+        std::vector<CollisionSphere> &tree    //!< Hierarchy, in post-order.
+        );
+
+    //! Finds the first contact of a bullet moving towards a target.
+    static void findContact(
+        const std::vector<CollisionSphere> &target, //!< Target hierarchy.
+        int i,                                      //!< Target node.
+        const std::vector<CollisionSphere> &bullet, //!< Bullet hierarchy.
+        int j,                                      //!< Bullet node.
+        const Coords::Vector &p,                    //!< Offset of the bullet.
+        const Coords::Vector &d,                    //!< Direction the bullet comes from.
+        double &best,                               //!< Largest contact distance found.
+        const CollisionSphere *&hit_target,         //!< Target primary in contact.
+        const CollisionSphere *&hit_bullet          //!< Bullet primary in contact.
+        );
+
+    //! Distance along the approach path at which two spheres first touch.
+    static bool contactDistance(
+        const CollisionSphere &target, //!< Target sphere.
+        const CollisionSphere &bullet, //!< Bullet sphere.
+        const Coords::Vector &p,       //!< Offset of the bullet.
+        const Coords::Vector &d,       //!< Direction the bullet comes from.
+        double &u                      //!< Contact distance.
         );
 
     //! Sets the radius of the bounding sphere.
@@ -151,6 +151,29 @@ public:
     // Set the chemical conditions to be variable.
     void SetVariableChem(bool vari = true);
 
+    // DEFERRED GAS-PHASE CHANGES.
+
+    //! Gas-phase changes collected from particle processes by one thread
+    struct GasChangeBuffer
+    {
+        fvector Concs;      //!< Species concentration changes (mol/m3)
+        double Temperature; //!< Temperature change from heat release (K)
+        double Expansion;   //!< Relative density change from molar change (constant pressure)
+        bool Changed;       //!< True if any change has been added
+    };
+
+    //! Collect gas-phase changes in n buffers instead of applying them
+    void DeferGasChanges(unsigned int n);
+
+    //! Returns true if gas-phase changes are being collected
+    bool GasChangesDeferred() const {return !m_gas_changes.empty();}
+
+    //! Returns the change buffer of the calling thread
+    GasChangeBuffer &GasChanges();
+
+    //! Apply the collected changes in one update and stop collecting them
+    void ApplyGasChanges();
+
 
     // PARTICLE INFLOW PROCESSES.
 
@@ -269,6 +292,10 @@ private:
 
     // Flag constant volume/pressure for particle temperature update
     bool m_constv;
+
+    // Buffers of deferred gas-phase concentration changes, one per
+    // thread.  Empty unless changes are being deferred.  Not copied.
+    std::vector<GasChangeBuffer> m_gas_changes;
 };
 
 } //namespace Sweep
@@ -196,6 +196,18 @@ public:
     //! Removes invalid particles.
     void RemoveInvalids(void);
 
+    //! Mark the particle at index i as changed, its tree leaf is refreshed later
+    void MarkDirty(unsigned int i);
+
+    //! Mark all particles as changed, so the tree is rebuilt by RemoveInvalids
+    void MarkAllDirty();
+
+    //! Set the fraction of changed particles above which the tree is rebuilt
+    void SetRebuildFraction(double frac);
+
+    //! Fraction of changed particles above which the tree is rebuilt
+    double RebuildFraction() const {return m_rebuild_fraction;}
+
     //! Replaces the particle at the given index with the given particle.
     void Replace (
         unsigned int i, // Index of particle to replace.
@@ -278,6 +290,9 @@ public:
     //! Inform the ensemble that the particle at index i has been changed
     void Update(unsigned int i);
 
+    //! Counter which changes whenever the particles or their sums may have changed
+    unsigned long Version() const {return m_version;}
+
     //! Get alpha for the ensemble (ABF model)
     double Alpha(double T) const;
 
@@ -291,7 +306,7 @@ public:
     unsigned int SetTotalParticleNumber();
     void ResetNumberAtIndex(unsigned int index);
     void UpdateNumberAtIndex(unsigned int index, int update);
-    void UpdateTotalParticleNumber(int update) { m_total_number += update; }
+    void UpdateTotalParticleNumber(int update) { ++m_version; m_total_number += update; }
     void UpdateTotalsWithIndex(unsigned int index, double change);
     void UpdateTotalsWithIndices(unsigned int i1, unsigned int i2);
 
@@ -444,6 +459,26 @@ private:
     //! Tree for inverting probability distributions on the particles and summing their properties
     tree_type m_tree;
 
+    // INCREMENTAL TREE MAINTENANCE.
+
+    //! Indices of particles changed since their tree leaves were last set
+    std::vector<unsigned int> m_dirty;
+
+    //! True if every tree leaf may be out of date
+    bool m_tree_stale;
+
+    //! Fraction of changed and invalid particles above which the tree is rebuilt
+    double m_rebuild_fraction;
+
+    //! Refresh the tree leaves of the particles marked dirty
+    void flushDirty();
+
+    //! Incremented by every operation which may change the particles or their sums
+    unsigned long m_version;
+
+    //! Remove the particle at index i by moving the last particle into its place
+    void eraseAt(unsigned int i, bool fdel);
+
 
     // MEMORY MANAGEMENT.
 
@@ -459,6 +494,9 @@ private:
     //! Empties the main population
     void ClearMain();
 
+    //! Removes invalid particles and rebuilds the whole tree
+    void removeInvalidsAndRebuild();
+
     //! Functor to extract weights from nodes of the new binary tree
     class WeightExtractor : public std::unary_function<const particle_cache_type&, double>
     {
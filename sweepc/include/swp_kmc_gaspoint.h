@@ -104,8 +104,14 @@ namespace KMC_ARS {
             Sweep::GasProfile* m_gasprof;
             std::vector<std::string> m_spnames;
 
-            //! Map profile number with column index
-            std::map<int, size_t> m_prof_in;
+            //! Column index in the profile of each variable, indexed by variable
+            std::vector<size_t> m_prof_in;
+
+            //! Index of the profile point found by the last Interpolate
+            size_t m_cursor;
+
+            //! Index of the first profile point after t, or of the last point
+            size_t locate(double t);
         };
 }
 }
@@ -79,8 +79,10 @@ namespace Sweep {
             virtual void initialise();
             //! Adds reaction
             void addReaction(std::vector<Sweep::KMC_ARS::Reaction>& rxnv, const Sweep::KMC_ARS::Reaction& rxn);
-            //! Calculate rates of each elementary reaction
-            void calculateElemRxnRate(std::vector<Sweep::KMC_ARS::Reaction>& rxnv, const KMCGasPoint& gp/*, const double t_now*/);
+            //! Calculate rates of each elementary reaction, returns false if they were already known for this gas point
+            bool calculateElemRxnRate(std::vector<Sweep::KMC_ARS::Reaction>& rxnv, const KMCGasPoint& gp/*, const double t_now*/);
+            //! Adds the site types whose counts the jump rate depends on
+            virtual void getSiteDependencies(std::vector<kmcSiteType>& types) const;
             //! Calculates jump process rates and store (for Pressures 0.0267, 0.12 & 1 atm; defined in derived classes)
             virtual double setRate0p0267(const KMCGasPoint& gp, PAHProcess& pah_st/*, const double& time_now*/);
             virtual double setRate0p12(const KMCGasPoint& gp, PAHProcess& pah_st/*, const double& time_now*/);
@@ -109,6 +111,10 @@ namespace Sweep {
             std::vector<Sweep::KMC_ARS::Reaction> m_rxnvector1;
             //! Vector which stores rates of elementary reactions
             std::vector<double> m_r;
+            //! Elementary reactions for which m_r was last calculated
+            const std::vector<Sweep::KMC_ARS::Reaction>* m_r_rxnv;
+            //! Gas point for which m_r was last calculated
+            std::vector<double> m_r_gas;
             //! Rate of reaction
             double m_rate;
             //! Name of process
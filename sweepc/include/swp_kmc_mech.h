@@ -54,6 +54,7 @@
 #include "swp_kmc_typedef.h"
 //#include "swp_kmc_structure_comp.h"
 #include "swp_kmc_gaspoint.h"
+#include "swp_sum_tree.h"
 #include "csv_io.h"
 
 #include <iostream>
@@ -128,6 +129,21 @@ namespace KMC_ARS {
         std::vector<double> m_rates;
         //! Total rate
         double m_totalrate;
+
+        //! Sum tree over m_rates, for selecting a jump process
+        Sweep::SumTree m_ratetree;
+        //! Site types whose counts the jump rates depend on
+        std::vector<kmcSiteType> m_deptypes;
+        //! Indices in m_deptypes of the site types of each jump process
+        std::vector<std::vector<size_t> > m_deps;
+        //! Site counts for which m_rates were last calculated
+        std::vector<unsigned int> m_depcounts;
+        //! Gas point for which m_rates were last calculated
+        std::vector<double> m_gasdata;
+        //! Pressure regime of the last rates, -1 if none
+        int m_regime;
+        //! Find the site types each jump process depends on
+        void buildDependencies();
     };
         
     //! Process list:
@@ -163,6 +179,7 @@ namespace KMC_ARS {
         double setRate0p0267(const KMCGasPoint& gp, PAHProcess& pah_st/*, const double& time_now*/);
         double setRate0p12(const KMCGasPoint& gp, PAHProcess& pah_st/*, const double& time_now*/);
         double setRate1(const KMCGasPoint& gp, PAHProcess& pah_st/*, const double& time_now*/);
+        void getSiteDependencies(std::vector<kmcSiteType>& types) const;
         void initialise();
     };
 
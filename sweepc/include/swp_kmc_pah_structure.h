@@ -61,6 +61,35 @@ namespace Sweep{
     namespace KMC_ARS{
         class JumpProcess;
         typedef std::vector<Spointer> svector;
+
+        //! Site vectors indexed by site type
+        /*!
+         * Replaces a std::map from site type to site vector.  The principal
+         * and combined site types (FE to None) have their own vector; any
+         * other type shares a spare vector, which stays empty as no sites
+         * of those types are stored.
+         */
+        class SiteMap {
+        public:
+            svector &operator[](kmcSiteType st) {return m_sites[slot(st)];}
+            const svector &operator[](kmcSiteType st) const {return m_sites[slot(st)];}
+
+            //! Empty all site vectors
+            void clear() {
+                for(int i=0; i!=Count; ++i) m_sites[i].clear();
+            }
+
+        private:
+            //! Number of site vectors, including the spare one
+            enum {Count = None + 2};
+
+            static int slot(kmcSiteType st) {
+                return (st >= 0 && st <= None) ? (int) st : Count - 1;
+            }
+
+            svector m_sites[Count];
+        };
+
         class PAHStructure{
         public:
             friend class PAHProcess;
@@ -70,7 +99,7 @@ namespace Sweep{
             //! Default Destructor
             ~PAHStructure();
             
-            //! Remove all data and free any memory
+            //! Remove all data and free the carbon and coordinate storage
             void clear();
 
             void setParent(Sweep::AggModels::PAH* parent);
@@ -81,7 +110,7 @@ namespace Sweep{
             bool operator!=(PAHStructure &rhs) const;
 
             //! Stores coordinates of all Carbon atoms (not according to order)
-            std::set<cpair> m_cpositions;
+            CoordMap m_cpositions;
             //! Initialise pah with pyrene (currently) or benzene
             void initialise(StartingStructure ss);
             PAHStructure* Clone() ;
@@ -117,7 +146,7 @@ namespace Sweep{
 
 			std::list<Site> GetSiteList() const;
 
-			std::map<kmcSiteType, svector> GetSiteMap() const;
+			const SiteMap &GetSiteMap() const;
 
         private:
             //! First and last Carbon atom in list
@@ -126,7 +155,7 @@ namespace Sweep{
             //! Stores all principal PAH sites in order from m_cfirst-m_clast.
             std::list<Site> m_siteList;
             //! Stores iterators to the PAH sites according to their site type
-            std::map<kmcSiteType, svector> m_siteMap;
+            SiteMap m_siteMap;
             //! Stores total counts of carbon and hydrogen
             intpair m_counts;
             //! Stores number of rings
@@ -50,16 +50,19 @@
 #include <list>
 #include <cmath>
 #include <cstdlib>
+#include <cstddef>
 #include <set>
+#include <vector>
 
 namespace Sweep {
     namespace KMC_ARS {
         // Forward Declarations
         struct Site;
         class Carbon;
+        class CarbonList;
 
         // Pointer to a Carbon atom and a Site.
-        typedef std::set< Carbon* > Ccontainer;
+        typedef CarbonList Ccontainer;
         typedef Carbon* Cpointer;
         typedef std::list< Site >::iterator Spointer;
         
@@ -88,6 +91,8 @@ namespace Sweep {
             angletype bondAngle2;
             //! Coordinates of atom
             cpair coords;
+            //! Position of atom in the carbon list of its PAH
+            unsigned int index;
         };
 
         //static Ccontainer NULLSET(1, Carbon());
@@ -103,6 +108,120 @@ namespace Sweep {
             Cpointer C1;
             Cpointer C2;
         };
+
+        //! Carbon atoms of a PAH, allocated in blocks
+        /*!
+         * Carbon objects are taken from blocks of contiguous storage and
+         * reused after they are released, so that adding and removing atoms
+         * during a KMC run rarely goes to the heap.  The first block is
+         * small and each new block is as large as all the earlier ones, so
+         * a small PAH holds little more storage than it uses.  The live atoms are
+         * also kept in a vector, in no particular order, and each atom
+         * stores its position in it so that it is released in constant time.
+         */
+        class CarbonList {
+        public:
+            typedef std::vector<Cpointer>::iterator iterator;
+            typedef std::vector<Cpointer>::const_iterator const_iterator;
+
+            //! Default Constructor
+            CarbonList();
+            //! Default Destructor, frees all blocks
+            ~CarbonList();
+
+            //! Take a default constructed carbon atom
+            Cpointer create();
+            //! Release a carbon atom, false if it is not in the list
+            bool release(Cpointer c);
+            //! Release all carbon atoms and free their blocks
+            void clear();
+
+            //! Number of carbon atoms
+            size_t size() const {return m_live.size();}
+
+            iterator begin() {return m_live.begin();}
+            iterator end() {return m_live.end();}
+            const_iterator begin() const {return m_live.begin();}
+            const_iterator end() const {return m_live.end();}
+
+        private:
+            //! Number of carbon atoms in the first block
+            static const unsigned int FirstBlockSize = 8;
+
+            //! Carbon atoms are not copied between lists
+            CarbonList(const CarbonList &copy);
+            CarbonList &operator=(const CarbonList &rhs);
+
+            //! Blocks of carbon atoms
+            std::vector<Cpointer> m_blocks;
+            //! Number of carbon atoms in all blocks
+            unsigned int m_capacity;
+            //! Carbon atoms in use
+            std::vector<Cpointer> m_live;
+            //! Released carbon atoms
+            std::vector<Cpointer> m_free;
+        };
+
+        //! Coordinates of the carbon atoms of a PAH
+        /*!
+         * Open addressing hash table, with linear probing, from coordinates
+         * to the carbon atom stored at that position.  It is used like a
+         * std::set of coordinates: inserting an occupied position does
+         * nothing, and erasing a position frees it whichever atom it holds.
+         * Erasing moves the following entries back, so no deleted markers
+         * are left in the table.  The table is allocated on the first
+         * insertion and doubled when it is half full.
+         */
+        class CoordMap {
+        public:
+            //! Default Constructor
+            CoordMap();
+
+            //! Number of occupied positions
+            size_t size() const {return m_size;}
+            //! Is no position occupied?
+            bool empty() const {return m_size == 0;}
+
+            //! 1 if the position is occupied, 0 otherwise
+            size_t count(const cpair &c) const;
+            //! Carbon atom at a position, NULL if there is none
+            Cpointer find(const cpair &c) const;
+            //! Occupy a position, false if it was already occupied
+            bool insert(const cpair &c, Cpointer C = NULL);
+            //! Free a position, returns the number of positions freed
+            size_t erase(const cpair &c);
+            //! Free all positions and the table
+            void clear();
+
+            //! Get the occupied positions in increasing order
+            void keys(std::vector<cpair> &out) const;
+
+            //! Are the same positions occupied?
+            bool operator==(const CoordMap &rhs) const;
+
+        private:
+            //! Slot of the hash table
+            struct Entry {
+                cpair coords;
+                Cpointer C;
+                bool used;
+            };
+
+            //! Slot at which the search for a position starts
+            size_t home(const cpair &c) const;
+            //! Slot holding a position, or the free slot ending its search
+            size_t locate(const cpair &c) const;
+            //! Number of slots of a new table
+            static const size_t FirstTableSize = 16;
+
+            //! Double the number of slots
+            void grow();
+
+            //! Slots, the number is zero or a power of 2
+            std::vector<Entry> m_table;
+            //! Number of occupied positions
+            size_t m_size;
+        };
         
 
         // To calculate increments in x coordinates and y coordinates given angle direction
@@ -202,6 +202,15 @@ public:
         fvector &rates   // Return vector for process rates.
         ) const;
 
+    //! Rates of non-deferred processes, optionally keeping the inception terms
+    double CalcJumpRateTerms(
+        double t,          // Time at which to get rates.
+        const Cell &sys, // System cell for which to get rates.
+        const Geometry::LocalGeometry1d& local_geom, // Information regarding surrounding cells
+        fvector &rates,  // Return vector for process rates.
+        bool inceptions  // Recalculate the inception terms?
+        ) const;
+
     //! Rate of processes that are deferred
     double CalcDeferredRateTerms(
         double t,          // Time at which to get rates.
@@ -277,8 +286,8 @@ public:
 		Sweep::PropID prop,
 		rng_type &rng) const;
 
-    //! LPDA for one particle
-    void UpdateParticle(
+    //! LPDA for one particle, returns true if the particle may have changed
+    bool UpdateParticle(
         Particle &sp, // Particle to update.
         Cell &sys,    // System to which the particle belongs.
         double t,       // Time up to which to integrate.
@@ -314,6 +323,10 @@ public:
     unsigned int GetHybridThreshold() const { return m_hybrid_threshold; }
     // ================================================
 
+    //! Set/get the number of threads over which the LPDA particle updates are distributed
+    void SetLPDAThreadCount(unsigned int n) { m_lpda_threads = (n > 0) ? n : 1; }
+    unsigned int LPDAThreadCount() const { return m_lpda_threads; }
+
 	//! Set/get the index that corresponds to the particle species in the gas-phase vector
 	void SetParticleSpeciesIndex(int index) const { m_i_particle_species = index; }
 	int GetParticleSpeciesIndex() const { return m_i_particle_species; }
@@ -370,6 +383,21 @@ private:
 
 	mutable int m_i_particle_species;         // Index of particulate species in gas-phase vector, used for enthalpy etc.
 
+    //! Number of threads over which the LPDA particle updates are distributed
+    unsigned int m_lpda_threads;
+
+    //! True if the LPDA particle updates for the system may be done concurrently
+    bool canUpdateInParallel(const Cell &sys) const;
+
+    //! LPDA for all particles, distributed over m_lpda_threads threads
+    void parallelUpdateParticles(
+        double t,                  // Time up to which to integrate.
+        Cell &sys,                 // System to update.
+        rng_type &rng,             // Generator from which the particle streams are seeded.
+        PartPtrVector &overflow,   // Particles created by the updates.
+        std::vector<char> &changed // Set non-zero for the particles that may have changed.
+        ) const;
+
     // Clears the mechanism from memory.
     void releaseMem(void);
 
@@ -0,0 +1,94 @@
+/*!
+ * \file   swp_object_pool.h
+ *
+ *  Project:        sweepc (population balance solver)
+ *  Sourceforge:    http://sourceforge.net/projects/mopssuite
+ *
+ * \brief  Pooled memory for particles and primaries
+ *
+ Licence:
+    This file is part of "sweepc".
+
+    sweepc is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+  Contact:
+    Prof Markus Kraft
+    Dept of Chemical Engineering
+    University of Cambridge
+    New Museums Site
+    Pembroke Street
+    Cambridge
+    CB2 3RA
+    UK
+
+    Email:       mk306@cam.ac.uk
+    Website:     http://como.cheng.cam.ac.uk
+ */
+
+#ifndef SWEEP_OBJECT_POOL_H
+#define SWEEP_OBJECT_POOL_H
+
+#include <cstddef>
+
+namespace Sweep
+{
+/*!
+ * \brief   Recycles the memory of particles and primaries
+ *
+ * Particles and primaries are created and destroyed in very large numbers
+ * by coagulation, inception, doubling and cloning.  Their class-specific
+ * operator new and delete draw on this pool, which carves large chunks into
+ * blocks of a fixed size class and keeps released blocks on free lists for
+ * reuse.  Each thread has its own free lists, so no locking is needed, and
+ * a block released by a thread other than the one that allocated it simply
+ * joins the free list of the releasing thread.
+ *
+ * Chunks are kept while any pooled object is alive, so the pool holds the
+ * high-water mark of particle memory until Purge returns it to the system.
+ * Ensembles call Purge when they are destroyed, so the memory is released
+ * once the last ensemble of a simulation has gone.  Objects larger than the
+ * largest size class are passed straight to the global operator new.
+ */
+class ObjectPool
+{
+public:
+    //! Return a block of at least n bytes
+    static void *Allocate(std::size_t n);
+
+    //! Return a block obtained from Allocate(n) to the pool
+    static void Release(void *p, std::size_t n);
+
+    //! Return all chunks to the system if no pooled object is alive
+    static bool Purge();
+
+    //! Size classes are multiples of this many bytes
+    static const std::size_t Granularity = 16;
+
+    //! Largest object size served from the pool
+    static const std::size_t MaxSize = 1024;
+
+    //! Number of size classes
+    static const std::size_t ClassCount = MaxSize / Granularity;
+
+private:
+    //! Number of bytes obtained from the system at a time
+    static const std::size_t ChunkSize = 64 * 1024;
+
+    //! Carve a new chunk into free blocks of size class c
+    static void refill(std::size_t c);
+};
+}
+
+#endif
@@ -48,6 +48,7 @@
 #include "swp_particle_model.h"
 #include "swp_property_indices.h"
 #include "swp_model_factory.h"
+#include "swp_object_pool.h"
 
 #include "camxml.h"
 
@@ -99,6 +100,12 @@ public:
 
 	// Destructor.
     virtual ~Particle(void);
+
+    //! Particle memory is drawn from the object pool
+    static void *operator new(std::size_t n) {return ObjectPool::Allocate(n);}
+
+    //! Return particle memory to the object pool
+    static void operator delete(void *p, std::size_t n) {ObjectPool::Release(p, n);}
     
     //! Create a new particle using the model according to the xml data
     static Particle* createFromXMLNode(const CamXML::Element& xml,
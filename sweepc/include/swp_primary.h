@@ -65,6 +65,7 @@
 #include "swp_sintering_model.h"
 #include "swp_titania_melting_model.h"
 #include "swp_property_indices.h"
+#include "swp_object_pool.h"
 
 #include <iostream>
 
@@ -109,6 +110,12 @@ public:
     // Destructors.
     virtual ~Primary(void);
 
+    //! Primary memory, including that of all subclasses, is drawn from the object pool
+    static void *operator new(std::size_t n) {return ObjectPool::Allocate(n);}
+
+    //! Return primary memory to the object pool
+    static void operator delete(void *p, std::size_t n) {ObjectPool::Release(p, n);}
+
     // Operators.
     virtual Primary &operator=(const Primary &rhs);
 
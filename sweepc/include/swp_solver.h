@@ -45,6 +45,7 @@
 
 #include "swp_mechanism.h"
 #include "swp_cell.h"
+#include "swp_sum_tree.h"
 
 #include <vector>
 #include <map>
@@ -92,6 +93,17 @@ public:
         rng_type &rng
         );
 
+    //! Performs a single stochastic event, selecting it from a rate tree
+    static void timeStep(
+        double &t,                // Current solution time.
+        double t_stop,            // Steps may not go past this time
+        Cell &sys,              // System to update.
+        const Geometry::LocalGeometry1d &geom, // Details of cell size
+        const Mechanism &mech,  // Mechanism to use.
+        const SumTree &rates,   // Current process rates.
+        rng_type &rng
+        );
+
 protected:
     // TIME STEPPING ROUTINES.
 
@@ -0,0 +1,113 @@
+/*!
+ * \file   swp_sum_tree.h
+ *
+ *  Project:        sweepc (population balance solver)
+ *  Sourceforge:    http://sourceforge.net/projects/mopssuite
+ *
+ * \brief  Binary sum tree over a vector of non-negative weights
+ *
+ Licence:
+    This file is part of "sweepc".
+
+    sweepc is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+  Contact:
+    Prof Markus Kraft
+    Dept of Chemical Engineering
+    University of Cambridge
+    New Museums Site
+    Pembroke Street
+    Cambridge
+    CB2 3RA
+    UK
+
+    Email:       mk306@cam.ac.uk
+    Website:     http://como.cheng.cam.ac.uk
+ */
+
+#ifndef SWEEP_SUM_TREE_H
+#define SWEEP_SUM_TREE_H
+
+#include "swp_params.h"
+
+namespace Sweep
+{
+/*!
+ * \brief   Sum tree for selecting from a vector of weights in logarithmic time
+ *
+ * The weights are the leaves of a complete binary tree whose inner nodes
+ * hold the sums of their two children: for n leaves (a power of two) the
+ * weights occupy elements [n, 2n) and element k < n holds the sum of
+ * elements 2k and 2k+1, so element 1 is the total.  Changing one weight
+ * updates the sums on its path to the root, and selecting a weight with
+ * probability proportional to its value descends from the root, both in
+ * O(log n).  The leaves keep the order of the weights, so that a given
+ * random number selects the same weight as a linear scan.
+ *
+ * This is the tree behind the jump process selection of Solver::Run and
+ * the KMC jump process selection.
+ *
+ * Inner nodes are recomputed from their children rather than adjusted by
+ * differences, so the sums do not drift as weights are updated.
+ */
+class SumTree
+{
+public:
+    //! Create an empty tree
+    SumTree();
+
+    //! Number of weights
+    unsigned int Size() const {return m_size;}
+
+    //! Sum of all weights
+    double Total() const {return m_size > 0 ? m_sums[1] : 0.0;}
+
+    //! Weight i
+    double Value(unsigned int i) const {return m_sums[m_leaves + i];}
+
+    //! Set the number of weights and zero them all
+    void Resize(unsigned int n);
+
+    //! Set weights first onwards, only the changed weights are updated
+    void Assign(const fvector &weights, unsigned int first = 0);
+
+    //! Set weight i and update the sums above it
+    void Update(unsigned int i, double w);
+
+    //! Set weight i without updating the sums above it
+    void SetLeaf(unsigned int i, double w) {m_sums[m_leaves + i] = w;}
+
+    //! Recompute all sums from the weights
+    void Rebuild();
+
+    //! Weight at which the cumulative sum first exceeds r
+    unsigned int Find(double r) const;
+
+    //! Select a weight with probability proportional to its value
+    int Select(double u) const;
+
+private:
+    //! Number of weights
+    unsigned int m_size;
+
+    //! Number of leaves, a power of two no smaller than m_size
+    unsigned int m_leaves;
+
+    //! Node sums, the root is node 1 and the children of node k are 2k and 2k+1
+    fvector m_sums;
+};
+}
+
+#endif
@@ -54,6 +54,7 @@
 #include <fstream>
 #include <stdexcept>
 #include <stack>
+#include <limits>
 
 using namespace Sweep;
 using namespace Sweep::AggModels;
@@ -469,7 +470,13 @@ BinTreePrimary &BinTreePrimary::Coagulate(const Primary &rhs, rng_type &rng)
 			//	Lindberg et al., J. Comp. Phys. 397, 108799, (2019)
 			///////////////////////////////////////////////////////////////////////////////
         
-			//! Incremental translation.
+			//! Bounding-sphere hierarchies of both particles. The left
+			//! particle is the bullet, it is only moved once its point of
+			//! contact with the right particle (the target) is known.
+			std::vector<CollisionSphere> bullet_tree, target_tree;
+			const int bullet_root = buildCollisionTree(*m_leftchild, bullet_tree);
+			const int target_root = buildCollisionTree(*m_rightchild, target_tree);
+
 			while (!Overlap) {
 				//! Sphere point picking. This is the random direction step of
 				//! Jullien's BCCA algorithm. It is incorrect to select spherical
@@ -570,78 +577,35 @@ BinTreePrimary &BinTreePrimary::Coagulate(const Primary &rhs, rng_type &rng)
 				double y4 = R[1][0] * x3 + R[1][1] * y3 + R[1][2] * z3;
 				double z4 = R[2][0] * x3 + R[2][1] * y3 + R[2][2] * z3;
 
-				this->m_leftchild->Translate(x4, y4, z4);
-            
-				//! The two particles are initially at the origin. Keep doubling
-				//! the distance between them so that they do not overlap. This is
-				//! more efficient than picking an arbitrarily large distance.
-				int numberOfOverlaps = 0;
-				int factorApart = 1;
-				double Separation = 0.0;
-
-				while (this->checkForOverlap(*m_leftchild, *m_rightchild, numberOfOverlaps, Separation)) {
-					this->m_leftchild->Translate(-factorApart * R[0][2] * sumr, -factorApart * R[1][2] * sumr, -factorApart * R[2][2] * sumr);
-					factorApart *= 2;
-				}    
-
-				numberOfOverlaps = 0;
-
-				while (!Overlap) {
-
-					double dx = this->m_leftchild->m_cen_bsph[0];
-					double dy = this->m_leftchild->m_cen_bsph[1];
-					double dz = this->m_leftchild->m_cen_bsph[2];
-
-					double oldDistance = dx * dx + dy * dy + dz * dz;
-
-					//! Translate particle in 1% increments.
-					this->m_leftchild->Translate(-0.01 * x * sumr, -0.01 * y * sumr, -0.01 * z * sumr);
-
-					Overlap = this->checkForOverlap(*m_leftchild, *m_rightchild, numberOfOverlaps, Separation);
-                
-					dx = this->m_leftchild->m_cen_bsph[0];
-					dy = this->m_leftchild->m_cen_bsph[1];
-					dz = this->m_leftchild->m_cen_bsph[2];
-
-					double newDistance = dx * dx + dy * dy + dz * dz;
-
-					//! If the left particle has failed to collide with the
-					//! particle at the origin (first condition) or if there are
-					//! multiple points of overlap (second condition), the trial is
-					//! abandoned and another trajectory is chosen.
-					if ((newDistance > oldDistance && newDistance > sumr * sumr) || (numberOfOverlaps > 1)) {
-						this->m_leftchild->centreBoundSph();
-						//this->m_leftchild->centreCOM();
-						numberOfOverlaps = 0;
-						Overlap = false;
-						break;
-					}
+				//! Rather than stepping the left particle towards the right
+				//! one and testing every pair of primaries at each step, find
+				//! the distance along the trajectory at which the first pair
+				//! of primaries touches. The bounding-sphere hierarchies prune
+				//! the pairs which cannot be hit, or cannot be hit first.
+				Coords::Vector d;
+				d[0] = x;
+				d[1] = y;
+				d[2] = z;
+
+				Coords::Vector p;
+				p[0] = x4;
+				p[1] = y4;
+				p[2] = z4;
+
+				double best = -std::numeric_limits<double>::max();
+				const CollisionSphere *hit_target = NULL;
+				const CollisionSphere *hit_bullet = NULL;
+				findContact(target_tree, target_root, bullet_tree, bullet_root,
+				            p, d, best, hit_target, hit_bullet);
+
+				//! If the left particle misses the particle at the origin, the
+				//! trial is abandoned and another trajectory is chosen.
+				if (hit_bullet != NULL) {
+					this->m_leftchild->Translate(x4 + best * x, y4 + best * y, z4 + best * z);
+					this->m_leftparticle = hit_bullet->leaf;
+					this->m_rightparticle = hit_target->leaf;
+					Overlap = true;
 				}
-
-				//! Newton bisection method to speed up translation.
-				//! Needs to be tested.
-				//double a = 0.0;
-				//double b = 0.0;
-				//double c = 0.0;
-
-				//b = this->m_leftchild->m_cen_bsph[2];
-				//double Translation = - (b - (a + b) / 2.0);
-
-				//numberOfOverlaps = 0;
-
-				//while (!(abs(Separation - 1) < 0.01 && numberOfOverlaps == 1)) {
-				//    this->m_leftchild->Translate(0, 0, Translation);
-
-				//    numberOfOverlaps = 0;
-
-				//    if (this->checkForOverlap(*m_leftchild, *m_rightchild, numberOfOverlaps, Separation)) {
-				//        a = this->m_leftchild->m_cen_bsph[2];
-				//        Translation = (a + b) / 2.0 - a;
-				//    } else {
-				//        b = this->m_leftchild->m_cen_bsph[2];
-				//        Translation = - (b - (a + b) / 2.0);
-				//    }
-				//}
 			}
 			///////////////////////////////////////////////////////////////////////////////
 		}
@@ -1006,6 +970,156 @@ bool BinTreePrimary::particlesOverlap(const Coords::Vector &p1, double r1,
     }
 }
 
+/*!
+ *  Builds the bounding-sphere hierarchy of a node from the positions and radii
+ *  of its primaries. The sphere of a leaf is the primary itself, the sphere
+ *  of any other node is the smallest sphere enclosing the spheres of its two
+ *  children. The spheres are built here rather than taken from the bounding
+ *  spheres stored in the tree, which are not kept up to date as the
+ *  primaries grow and sinter.
+ *
+ *  @param[in]     node    Root of the hierarchy.
+ *  @param[in,out] tree    Nodes of the hierarchy, appended in post-order.
+ *
+ *  @return Index of the root in tree.
+ */
+int BinTreePrimary::buildCollisionTree(BinTreePrimary &node, std::vector<CollisionSphere> &tree)
+{
+    CollisionSphere s;
+
+    if (node.isLeaf()) {
+        s.centre = node.boundSphCentre();
+        s.radius = node.Radius();
+        s.left = -1;
+        s.right = -1;
+        s.leaf = &node;
+    } else {
+        s.left = buildCollisionTree(*node.m_leftchild, tree);
+        s.right = buildCollisionTree(*node.m_rightchild, tree);
+        s.leaf = NULL;
+
+        const CollisionSphere &a = tree[s.left];
+        const CollisionSphere &b = tree[s.right];
+        const double dx = b.centre[0] - a.centre[0];
+        const double dy = b.centre[1] - a.centre[1];
+        const double dz = b.centre[2] - a.centre[2];
+        const double dist = sqrt(dx * dx + dy * dy + dz * dz);
+
+        if (dist + b.radius <= a.radius) {
+            s.centre = a.centre;
+            s.radius = a.radius;
+        } else if (dist + a.radius <= b.radius) {
+            s.centre = b.centre;
+            s.radius = b.radius;
+        } else {
+            s.radius = 0.5 * (dist + a.radius + b.radius);
+            const double f = (s.radius - a.radius) / dist;
+            s.centre[0] = a.centre[0] + f * dx;
+            s.centre[1] = a.centre[1] + f * dy;
+            s.centre[2] = a.centre[2] + f * dz;
+        }
+
+        //! Allow for round-off, so that the sphere surely encloses its
+        //! children.
+        s.radius *= 1.0 + 1.0e-12;
+    }
+
+    tree.push_back(s);
+    return tree.size() - 1;
+}
+
+/*!
+ *  The bullet is at p + u * d, and comes in from large u. The spheres first
+ *  touch at the larger root u of |c_b + p + u * d - c_t| = r_t + r_b.
+ *
+ *  @param[in]  target  Target sphere.
+ *  @param[in]  bullet  Bullet sphere.
+ *  @param[in]  p       Offset of the bullet.
+ *  @param[in]  d       Unit vector of the direction the bullet comes from.
+ *  @param[out] u       Contact distance along d.
+ *
+ *  @return Do the spheres touch anywhere along the path?
+ */
+bool BinTreePrimary::contactDistance(const CollisionSphere &target, const CollisionSphere &bullet,
+                                     const Coords::Vector &p, const Coords::Vector &d, double &u)
+{
+    const double wx = bullet.centre[0] + p[0] - target.centre[0];
+    const double wy = bullet.centre[1] + p[1] - target.centre[1];
+    const double wz = bullet.centre[2] + p[2] - target.centre[2];
+    const double sumr = target.radius + bullet.radius;
+
+    const double wd = wx * d[0] + wy * d[1] + wz * d[2];
+    const double disc = wd * wd - (wx * wx + wy * wy + wz * wz) + sumr * sumr;
+
+    if (disc < 0.0) return false;
+
+    u = -wd + sqrt(disc);
+    return true;
+}
+
+/*!
+ *  Branch-and-bound search for the pair of primaries which touches first, i.e.
+ *  at the largest contact distance. The contact distance of two enclosing
+ *  spheres bounds those of all pairs of primaries inside them, so a pair of
+ *  nodes is skipped if its spheres miss each other or cannot touch before the
+ *  best contact found so far. The larger of the two nodes is split.
+ *
+ *  @param[in]     target      Target hierarchy.
+ *  @param[in]     i           Target node.
+ *  @param[in]     bullet      Bullet hierarchy.
+ *  @param[in]     j           Bullet node.
+ *  @param[in]     p           Offset of the bullet.
+ *  @param[in]     d           Unit vector of the direction the bullet comes from.
+ *  @param[in,out] best        Largest contact distance found.
+ *  @param[in,out] hit_target  Target primary of the best contact.
+ *  @param[in,out] hit_bullet  Bullet primary of the best contact.
+ */
+void BinTreePrimary::findContact(const std::vector<CollisionSphere> &target, int i,
+                                 const std::vector<CollisionSphere> &bullet, int j,
+                                 const Coords::Vector &p, const Coords::Vector &d, double &best,
+                                 const CollisionSphere *&hit_target,
+                                 const CollisionSphere *&hit_bullet)
+{
+    const CollisionSphere &a = target[i];
+    const CollisionSphere &b = bullet[j];
+
+    double u = 0.0;
+    if (!contactDistance(a, b, p, d, u) || (u <= best)) return;
+
+    if ((a.leaf != NULL) && (b.leaf != NULL)) {
+        best = u;
+        hit_target = &a;
+        hit_bullet = &b;
+        return;
+    }
+
+    //! Split the larger node, and search the child with the larger bound
+    //! first so that the other one is more likely to be pruned.
+    if ((b.leaf != NULL) || ((a.leaf == NULL) && (a.radius >= b.radius))) {
+        double ul = -std::numeric_limits<double>::max(), ur = ul;
+        contactDistance(target[a.left], b, p, d, ul);
+        contactDistance(target[a.right], b, p, d, ur);
+        if (ul >= ur) {
+            findContact(target, a.left, bullet, j, p, d, best, hit_target, hit_bullet);
+            findContact(target, a.right, bullet, j, p, d, best, hit_target, hit_bullet);
+        } else {
+            findContact(target, a.right, bullet, j, p, d, best, hit_target, hit_bullet);
+            findContact(target, a.left, bullet, j, p, d, best, hit_target, hit_bullet);
+        }
+    } else {
+        double ul = -std::numeric_limits<double>::max(), ur = ul;
+        contactDistance(a, bullet[b.left], p, d, ul);
+        contactDistance(a, bullet[b.right], p, d, ur);
+        if (ul >= ur) {
+            findContact(target, i, bullet, b.left, p, d, best, hit_target, hit_bullet);
+            findContact(target, i, bullet, b.right, p, d, best, hit_target, hit_bullet);
+        } else {
+            findContact(target, i, bullet, b.right, p, d, best, hit_target, hit_bullet);
+            findContact(target, i, bullet, b.left, p, d, best, hit_target, hit_bullet);
+        }
+    }
+}
+
 //! Calculates the radius of gyration of a particle
 //! assuming primaries are point masses.
 double BinTreePrimary::RadiusOfGyration() const
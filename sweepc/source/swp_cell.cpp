@@ -49,6 +49,10 @@
 
 #include <stdexcept>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #include <boost/random/uniform_01.hpp>
 #include <boost/random/mersenne_twister.hpp>
 
@@ -302,6 +306,99 @@ void Cell::SetFixedChem(bool fixed) {m_fixed_chem = fixed;}
 void Cell::SetVariableChem(bool vari) {m_fixed_chem = !vari;}
 
 
+// DEFERRED GAS-PHASE CHANGES.
+
+/*!
+ * Particle processes add their gas-phase concentration and temperature
+ * changes to the buffers instead of changing the gas phase.  This lets
+ * particles be updated concurrently, and replaces the many small updates
+ * of an LPDA pass with one.  The changes are applied by ApplyGasChanges.
+ *
+ *@param[in]    n       Number of buffers (one per thread)
+ */
+void Cell::DeferGasChanges(unsigned int n)
+{
+    GasChangeBuffer empty;
+    empty.Concs.assign(m_model->Species()->size(), 0.0);
+    empty.Temperature = 0.0;
+    empty.Expansion   = 0.0;
+    empty.Changed     = false;
+    m_gas_changes.assign(max(n, 1u), empty);
+}
+
+/*!
+ *@return       Change buffer for the calling thread
+ *
+ *@pre          Gas-phase changes are being deferred
+ */
+Cell::GasChangeBuffer &Cell::GasChanges()
+{
+    assert(GasChangesDeferred());
+#ifdef _OPENMP
+    return m_gas_changes[omp_get_thread_num() % m_gas_changes.size()];
+#else
+    return m_gas_changes[0];
+#endif
+}
+
+/*!
+ * The buffers are summed in order and applied in a single update of the
+ * gas phase.  At constant pressure a temperature change expands the gas
+ * as in Process::adjustParticleTemperature, and the sample volume is
+ * scaled to conserve mass.
+ *
+ *@exception    std::runtime_error      Gas phase is not a SprogIdealGasWrapper
+ */
+void Cell::ApplyGasChanges()
+{
+    if (!GasChangesDeferred())
+        return;
+
+    // Sum the buffers of all threads.
+    GasChangeBuffer &total = m_gas_changes[0];
+    for (unsigned int b = 1; b < m_gas_changes.size(); ++b) {
+        const GasChangeBuffer &buf = m_gas_changes[b];
+        if (!buf.Changed) continue;
+        for (unsigned int k = 0; k != total.Concs.size(); ++k)
+            total.Concs[k] += buf.Concs[k];
+        total.Temperature += buf.Temperature;
+        total.Expansion   += buf.Expansion;
+        total.Changed = true;
+    }
+
+    if (total.Changed && !m_fixed_chem) {
+        SprogIdealGasWrapper *gasWrapper = dynamic_cast<SprogIdealGasWrapper*>(m_gas);
+        if (gasWrapper == NULL)
+            throw std::runtime_error("Could not cast gas phase to SprogIdealGasWrapper in Cell::ApplyGasChanges");
+        Sprog::Thermo::IdealGas *gas = gasWrapper->Implementation();
+
+        const double rhog_mass = gas->MassDensity();
+        const double oldTg = gas->Temperature();
+
+        fvector newConcs;
+        gas->GetConcs(newConcs);
+        for (unsigned int k = 0; k != newConcs.size(); ++k)
+            newConcs[k] += total.Concs[k];
+
+        if (total.Temperature != 0.0)
+            gas->SetTemperature(oldTg + total.Temperature);
+
+        if (!m_constv && ((total.Temperature != 0.0) || (total.Expansion != 0.0))) {
+            // Gas-phase expansion at constant pressure.
+            const double gamma = total.Expansion + (total.Temperature / oldTg);
+            for (unsigned int k = 0; k != newConcs.size(); ++k)
+                newConcs[k] -= (gamma * newConcs[k]);
+            gas->SetConcs(newConcs);
+            AdjustSampleVolume(rhog_mass / gas->MassDensity());
+        } else {
+            gas->SetConcs(newConcs);
+        }
+    }
+
+    m_gas_changes.clear();
+}
+
+
 // PARTICLE INFLOW PROCESSES.
 
 // Returns the number of inflow processes defined
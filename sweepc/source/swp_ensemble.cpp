@@ -62,10 +62,17 @@
 
 using namespace Sweep;
 
+// Default fraction of changed and invalid particles up to which the tree
+// leaves are refreshed in place.  A refresh touches about log2(n) nodes and
+// a rebuild about 2n, so refreshing 5% of the leaves stays cheaper than a
+// rebuild for any practical ensemble size.
+static const double default_rebuild_fraction = 0.05;
+
 // CONSTRUCTORS AND DESTRUCTORS.
 
 // Default constructor.
 Sweep::Ensemble::Ensemble(void)
+: m_tree_stale(false), m_rebuild_fraction(default_rebuild_fraction), m_version(0)
 {
 	m_kmcsimulator= NULL;
     init();
@@ -73,7 +80,7 @@ Sweep::Ensemble::Ensemble(void)
 
 // Initialising constructor.
 Sweep::Ensemble::Ensemble(unsigned int count)
-: m_tree(count)
+: m_tree(count), m_tree_stale(false), m_rebuild_fraction(default_rebuild_fraction), m_version(0)
 {
     // Call initialisation routine.
     //If there are no particles, do not initialise binary tree
@@ -88,7 +95,7 @@ Sweep::Ensemble::Ensemble(unsigned int count)
 
 // Copy contructor.
 Sweep::Ensemble::Ensemble(const Sweep::Ensemble &copy)
-:m_tree(copy.m_tree)
+:m_tree(copy.m_tree), m_tree_stale(false), m_rebuild_fraction(default_rebuild_fraction), m_version(0)
 {
     // Use assignment operator.
     *this = copy;
@@ -96,6 +103,7 @@ Sweep::Ensemble::Ensemble(const Sweep::Ensemble &copy)
 
 // Stream-reading constructor.
 Sweep::Ensemble::Ensemble(std::istream &in, const Sweep::ParticleModel &model)
+: m_tree_stale(false), m_rebuild_fraction(default_rebuild_fraction), m_version(0)
 {
     Deserialize(in, model);
 }
@@ -106,6 +114,9 @@ Sweep::Ensemble::~Ensemble(void)
 	delete     m_kmcsimulator;
     // Clear the ensemble.
     Clear();
+    // Return the particle memory to the system if this ensemble held
+    // the last pooled particles.
+    ObjectPool::Purge();
 }
 
 
@@ -114,10 +125,13 @@ Sweep::Ensemble::~Ensemble(void)
 // Assignment operator.
 Ensemble & Sweep::Ensemble::operator=(const Sweep::Ensemble &rhs)
 {
+    ++m_version;
     if (this != &rhs) {
         // Clear current particles.
         Clear();
 
+        m_rebuild_fraction = rhs.m_rebuild_fraction;
+
         if (rhs.m_capacity > 0) {
             // Resize particle vector.
             m_particles.resize(rhs.m_capacity, NULL);
@@ -262,6 +276,7 @@ std::ostream& Sweep::operator<<(
  */
 void Sweep::Ensemble::Initialise(unsigned int capacity)
 {
+    ++m_version;
     // Clear current ensemble.
     Clear();
 
@@ -373,6 +388,7 @@ bool Sweep::Ensemble::IsDoublingOn() {
 void Sweep::Ensemble::SetParticles(std::list<Particle*>::iterator first, std::list<Particle*>::iterator last,
                                    rng_type &rng)
 {
+    ++m_version;
     // Clear any existing particles
     for(iterator it = m_particles.begin(); it != m_particles.end(); ++it) {
         delete *it;
@@ -510,6 +526,7 @@ Particle *const Sweep::Ensemble::GetPNParticleAt(unsigned int index)
  */
 int Sweep::Ensemble::Add(Particle &sp, rng_type &rng, int i2, bool hybrid_event_flag)
 {
+    ++m_version;
     // Check for doubling activation.
     if (!m_dbleactive && ((m_count + m_total_number) >= m_dblecutoff-1)) {
         m_dbleactive = true;
@@ -589,6 +606,7 @@ int Sweep::Ensemble::Add(Particle &sp, rng_type &rng, int i2, bool hybrid_event_
 // Store template particle at a specific index
 int Sweep::Ensemble::SetPNParticle(Particle &sp, unsigned int index)
 {
+	++m_version;
 	if (index < m_hybrid_threshold)
 	{
 		m_pn_particles[index] = &sp;
@@ -614,8 +632,8 @@ int Sweep::Ensemble::CheckforPAH(Sweep::KMC_ARS::PAHStructure &m_PAH, double t,
 					&& pah->NumRings() == m_PAH.numofRings()
 					&& pah->NumRings5() == m_PAH.numofRings5()){
 
-					std::map<KMC_ARS::kmcSiteType, KMC_ARS::svector> sitemapInput = m_PAH.GetSiteMap();
-					std::map<KMC_ARS::kmcSiteType, KMC_ARS::svector> sitemapComp = (*(pah->GetPAHVector())[0]).GetPAHStruct()->GetSiteMap();
+					const KMC_ARS::SiteMap &sitemapInput = m_PAH.GetSiteMap();
+					const KMC_ARS::SiteMap &sitemapComp = (*(pah->GetPAHVector())[0]).GetPAHStruct()->GetSiteMap();
 					if (sitemapInput[KMC_ARS::FE].size() == sitemapComp[KMC_ARS::FE].size() &&
 						sitemapInput[KMC_ARS::ZZ].size() == sitemapComp[KMC_ARS::ZZ].size() &&
 						sitemapInput[KMC_ARS::AC].size() == sitemapComp[KMC_ARS::AC].size() &&
@@ -653,6 +671,7 @@ int Sweep::Ensemble::CheckforPAH(Sweep::KMC_ARS::PAHStructure &m_PAH, double t,
  */
 void Sweep::Ensemble::Remove(unsigned int i, bool fdel)
 {
+    ++m_version;
     //if (m_particles[i]->Primary()->AggID() ==AggModels::PAH_KMC_ID)
     //    {
     //        const Sweep::AggModels::PAHPrimary *rhsparticle = NULL;
@@ -671,7 +690,29 @@ void Sweep::Ensemble::Remove(unsigned int i, bool fdel)
 			doubling = false;
 		}
 	}
-	
+
+    // Moving the last particle would invalidate pending dirty indices
+    flushDirty();
+
+    eraseAt(i, fdel);
+
+    // Particle removal might reduce the particle count
+    // sufficiently to require particle doubling.
+	// But only do so if not using IWDSA as otherwise ensemble is likely to overflow during next LPDA
+	if(doubling) dble();
+
+    assert(m_tree.size() == m_count);
+}
+
+/*!
+ * @param[in]   i       Index of particle to remove
+ * @param[in]   fdel    True if delete should be called on removed particle
+ *
+ * The last particle is moved into position i and the tree leaves of both
+ * positions are updated, so only two root paths of the tree are touched.
+ */
+void Sweep::Ensemble::eraseAt(unsigned int i, bool fdel)
+{
 	//Set tracked pointer to null
 	if (m_tracked_number > 0){
 		for (unsigned int ii = 0; ii < m_tracked_particles.size(); ++ii){
@@ -705,17 +746,51 @@ void Sweep::Ensemble::Remove(unsigned int i, bool fdel)
 
         m_tree.pop_back();
     }
+}
+
+// Removes invalid particles from the ensemble.
+void Sweep::Ensemble::RemoveInvalids(void)
+{
+    ++m_version;
+    // Count the invalid particles to decide whether the tree can be
+    // maintained in place or must be rebuilt.
+    const unsigned int ninvalid = std::count_if(m_particles.begin(),
+                                                m_particles.begin() + m_count,
+                                                std::not1(std::mem_fun(&Particle::IsValid)));
+
+    if (!m_tree_stale &&
+        (ninvalid + m_dirty.size() <= m_rebuild_fraction * m_count)) {
+        // Refresh the changed leaves, then remove the invalid particles
+        // one at a time by moving the last particle into their place.
+        flushDirty();
+        unsigned int i = 0;
+        while (i < m_count) {
+            if (m_particles[i]->IsValid())
+                ++i;
+            else
+                eraseAt(i, true);
+        }
+    } else {
+        removeInvalidsAndRebuild();
+    }
 
-    // Particle removal might reduce the particle count
-    // sufficiently to require particle doubling.
-	// But only do so if not using IWDSA as otherwise ensemble is likely to overflow during next LPDA
-	if(doubling) dble();
+    // Stop doubling because the number of particles has dropped from above
+    // m_dblelimit during this function, which means a rapid loss of particles
+    // so doubling will make the sample volume needlessly large.
+    if((m_count + m_total_number) < m_capacity - m_dblecutoff) {
+        m_dbleactive = false;
+    }
 
+    // If we removed too many invalid particles then we'll have to double.
+    dble();
     assert(m_tree.size() == m_count);
 }
 
-// Removes invalid particles from the ensemble.
-void Sweep::Ensemble::RemoveInvalids(void)
+/*!
+ * Collects all invalid particles at the end of the particle vector,
+ * deletes them and rebuilds the whole tree.
+ */
+void Sweep::Ensemble::removeInvalidsAndRebuild()
 {
     // This function loops forward through the list finding invalid
     // particles and backwards finding valid particles.  Once an invalid
@@ -751,17 +826,6 @@ void Sweep::Ensemble::RemoveInvalids(void)
 
     // Rebuild the binary tree structure
     rebuildTree();
-
-    // Stop doubling because the number of particles has dropped from above
-    // m_dblelimit during this function, which means a rapid loss of particles
-    // so doubling will make the sample volume needlessly large.
-    if((m_count + m_total_number) < m_capacity - m_dblecutoff) {
-        m_dbleactive = false;
-    }
-
-    // If we removed too many invalid particles then we'll have to double.
-    dble();
-    assert(m_tree.size() == m_count);
 }
 
 /*!
@@ -777,6 +841,7 @@ void Sweep::Ensemble::RemoveInvalids(void)
  */
 void Sweep::Ensemble::Replace(unsigned int i, Particle &sp)
 {
+    ++m_version;
     // if (m_particles[i]->Primary()->AggID() ==AggModels::PAH_KMC_ID)
     //{
     //    const Sweep::AggModels::PAHPrimary *rhsparticle = NULL;
@@ -814,6 +879,7 @@ void Sweep::Ensemble::Replace(unsigned int i, Particle &sp)
  *  memory and reseting all details of the ensemble except its capacity
  */
 void Sweep::Ensemble::Clear() {
+    ++m_version;
     ClearMain();
 }
 
@@ -836,6 +902,8 @@ void Sweep::Ensemble::ClearMain()
     m_wtdcontfctr = 1.0;
 
     m_tree.clear();
+    m_dirty.clear();
+    m_tree_stale = false;
 
     // Reset doubling.
     m_maxcount   = 0;
@@ -908,6 +976,7 @@ int Sweep::Ensemble::Select(Sweep::PropID id, rng_type &rng) const
     // Calculate random number weighted by sum of desired property (wtid).
     // Set up the rng sample
     boost::uniform_01<rng_type&, double> unifDistrib(rng);
+
     double r = unifDistrib() * m_tree.head().Property(id);
 
     WeightExtractor we(id);
@@ -965,6 +1034,7 @@ double Sweep::Ensemble::Scaling() const
 // Resets the ensemble scaling.
 void Sweep::Ensemble::ResetScaling()
 {
+    ++m_version;
     m_ncont = 0;
     m_wtdcontfctr = 1.0;
     m_ndble = 0;
@@ -1043,10 +1113,12 @@ double Sweep::Ensemble::Alpha(double T) const {
 // Update functions
 void Sweep::Ensemble::UpdateNumberAtIndex(unsigned int index, int update)
 {
+    ++m_version;
     m_particle_numbers[index] += update;
 }
 void Sweep::Ensemble::UpdateTotalsWithIndex(unsigned int index, double change)
 {
+    ++m_version;
     m_total_diameter += change * m_pn_diameters[index];
     m_total_diameter2 += change * m_pn_diameters2[index];
     m_total_diameter_1 += change * m_pn_diameters_1[index];
@@ -1061,6 +1133,7 @@ void Sweep::Ensemble::UpdateTotalsWithIndex(unsigned int index, double change)
 }
 void Sweep::Ensemble::UpdateTotalsWithIndices(unsigned int i1, unsigned int i2)
 {
+    ++m_version;
     m_total_diameter += m_particle_numbers[i1] * (m_pn_diameters[i2] - m_pn_diameters[i1]);
     m_total_diameter2 += m_particle_numbers[i1] * (m_pn_diameters2[i2] - m_pn_diameters2[i1]);
     m_total_diameter_1 += m_particle_numbers[i1] * (m_pn_diameters_1[i2] - m_pn_diameters_1[i1]);
@@ -1077,6 +1150,7 @@ void Sweep::Ensemble::UpdateTotalsWithIndices(unsigned int i1, unsigned int i2)
 // For doubling algorithm
 void Sweep::Ensemble::DoubleTotals()
 {
+    ++m_version;
     m_total_diameter *= 2.0;
     m_total_diameter2 *= 2.0;
     m_total_diameter_1 *= 2.0;
@@ -1275,12 +1349,14 @@ double Sweep::Ensemble::GetPropertyTotal(Sweep::PropID prop) const
 // Reset functions
 void Sweep::Ensemble::ResetNumberAtIndex(unsigned int index)
 {
+    ++m_version;
     m_particle_numbers[index] = 0;
 }
 
 // Set functions
 void Sweep::Ensemble::InitialiseParticleNumberModel()
 {
+    ++m_version;
     m_particle_numbers.resize(m_hybrid_threshold, 0);
     m_pn_mass.resize(m_hybrid_threshold, 0);
     m_pn_diameters3.resize(m_hybrid_threshold, 0);
@@ -1295,6 +1371,7 @@ void Sweep::Ensemble::InitialiseParticleNumberModel()
 }
 void Sweep::Ensemble::InitialiseDiameters(double molecularWeight, double density)
 {
+    ++m_version;
     double expon = 1.0 / 3.0;
     for (unsigned int i = 1; i < m_hybrid_threshold; ++i){
         m_pn_mass[i] = (i / NA) * (molecularWeight);
@@ -1310,6 +1387,7 @@ void Sweep::Ensemble::InitialiseDiameters(double molecularWeight, double density
     }
 }
 unsigned int Sweep::Ensemble::SetTotalParticleNumber() {
+    ++m_version;
     m_total_number = 0.0;
     for (unsigned int i = 0; i < m_hybrid_threshold; ++i){
         m_total_number += m_particle_numbers[i];
@@ -1322,6 +1400,7 @@ unsigned int Sweep::Ensemble::SetTotalParticleNumber() {
 // suitable for coagulation terms.
 void Sweep::Ensemble::RecalcPNPropertySums()
 {
+    ++m_version;
      m_total_diameter = 0.0;
      m_total_diameter2 = 0.0;
      m_total_diameter_1 = 0.0;
@@ -1367,13 +1446,69 @@ void Sweep::Ensemble::RecalcPNPropertySums()
  */
 void Sweep::Ensemble::Update(unsigned int i)
 {
+    ++m_version;
     m_tree.replace(m_tree.begin() + i, tree_type::value_type(*m_particles[i], m_particles.begin() + i));
 }
 
+/*!
+ * @param[in]   i       Index of particle which has been changed
+ *
+ * Unlike Update, the tree leaf is not refreshed immediately but by the
+ * next call to RemoveInvalids, so a particle marked several times is only
+ * refreshed once.  Selections and sums made before then do not reflect
+ * the change.
+ */
+void Sweep::Ensemble::MarkDirty(unsigned int i)
+{
+    ++m_version;
+    m_dirty.push_back(i);
+}
+
+/*!
+ * Used after operations which change particles in place without recording
+ * which ones; the next call to RemoveInvalids rebuilds the tree.
+ */
+void Sweep::Ensemble::MarkAllDirty()
+{
+    ++m_version;
+    m_tree_stale = true;
+    m_dirty.clear();
+}
+
+/*!
+ * @param[in]   frac    Fraction of the particle count
+ *
+ * When RemoveInvalids finds no more than frac * Count() changed and invalid
+ * particles, it updates their tree leaves in place rather than rebuilding
+ * the whole tree.  The same threshold applies to the particles added by
+ * the doubling algorithm.  The default is 0.05; 0 always rebuilds.
+ *
+ * @exception   std::invalid_argument   Fraction outside [0, 1]
+ */
+void Sweep::Ensemble::SetRebuildFraction(double frac)
+{
+    if ((frac < 0.0) || (frac > 1.0))
+        throw std::invalid_argument("Tree rebuild fraction must lie in [0, 1] "
+                                    "(Sweep, Ensemble::SetRebuildFraction).");
+    m_rebuild_fraction = frac;
+}
+
+// Refresh the tree leaves of the particles marked dirty.
+void Sweep::Ensemble::flushDirty()
+{
+    for (std::vector<unsigned int>::const_iterator it = m_dirty.begin();
+         it != m_dirty.end(); ++it) {
+        if (*it < m_count)
+            Update(*it);
+    }
+    m_dirty.clear();
+}
+
 /*!
  * Replace the contents of the weights tree
  */
 void Ensemble::rebuildTree() {
+    ++m_version;
 
     // Iterators to loop over all the particles
     iterator itPart = begin();
@@ -1389,6 +1524,8 @@ void Ensemble::rebuildTree() {
 
     // Put the data into the tree
     m_tree.assign(newTreeValues.begin(), newTreeValues.end());
+    m_dirty.clear();
+    m_tree_stale = false;
 }
 
 // PRIVATE FUNCTIONS.
@@ -1403,6 +1540,7 @@ void Ensemble::rebuildTree() {
  */
 void Sweep::Ensemble::dble()
 {
+    ++m_version;
     // The doubling algorithm is activated if the number of particles
     // in the ensemble falls below half capacity.  It copies the whole particle
     // list and changes the scaling factor to keep it consistent.  Once the
@@ -1487,9 +1625,19 @@ void Sweep::Ensemble::dble()
 
         m_maxcount = std::max(m_maxcount, m_count);
 
-        // Reset the contents of the binary tree to match the new population, if it has been changed
-        if(originalCount < m_count)
-            rebuildTree();
+        // Reset the contents of the binary tree to match the new population, if it has been changed.
+        // A few added particles are pushed onto the tree, more than that and it is rebuilt.
+        if(originalCount < m_count) {
+            if (!m_tree_stale &&
+                (m_count - originalCount + m_dirty.size() <= m_rebuild_fraction * m_count)) {
+                flushDirty();
+                for (unsigned int i = originalCount; i != m_count; ++i) {
+                    m_tree.push_back(tree_type::value_type(*m_particles[i], m_particles.begin() + i));
+                }
+            } else {
+                rebuildTree();
+            }
+        }
 
 		//Remove tracking flags from untracked duplicates
 		if (m_tracked_number > 0){
@@ -1513,6 +1661,7 @@ void Sweep::Ensemble::dble()
  * storage allocated.
  */
 Sweep::PartPtrList Sweep::Ensemble::TakeParticles() {
+    ++m_version;
     // Copy the pointers to particles
     PartPtrList listOfParticles(begin(), end());
 
@@ -1637,6 +1786,7 @@ void Sweep::Ensemble::Serialize(std::ostream &out) const
  */
 void Sweep::Ensemble::Deserialize(std::istream &in, const Sweep::ParticleModel &model)
 {
+    ++m_version;
     Clear();
 
     if (in.good()) {
@@ -1825,6 +1975,11 @@ void Sweep::Ensemble::init(void)
     m_dbleslack  = 0;
     m_dbleon     = true;
 
+    // Incremental tree maintenance.
+    m_dirty.clear();
+    m_tree_stale = false;
+    m_rebuild_fraction = default_rebuild_fraction;
+
 	m_tracked_number = 0;
 
     // Hybrid particle-number/particle model parameters
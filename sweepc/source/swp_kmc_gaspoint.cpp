@@ -47,6 +47,9 @@
 #include "gpc_species.h"
 #include "comostrings.h"
 
+#include <algorithm>
+#include <stdexcept>
+
 using namespace Sweep;
 using namespace Sweep::KMC_ARS;
 
@@ -56,7 +59,8 @@ KMCGasPoint::KMCGasPoint():
 		m_data(),
 		m_gasprof(NULL),
 		m_spnames(),
-		m_prof_in()
+		m_prof_in(),
+		m_cursor(0)
 {}
 
 //! Constructor from a GasProfile object
@@ -65,13 +69,15 @@ KMCGasPoint::KMCGasPoint(Sweep::GasProfile& gasprof,
 				m_data(),
 				m_gasprof(NULL),
 				m_spnames(),
-				m_prof_in()
+				m_prof_in(),
+				m_cursor(0)
 {
     m_gasprof = &gasprof;
     initData();
     std::vector<std::string> spname;
     for(size_t i=0; i<sptrv.size(); i++)
         spname.push_back(sptrv[i]->Name());
+    m_prof_in.assign(m_total, 0);
     for(int i=H2; i<=CO2; i++) {
         m_prof_in[i] = Strings::findinlist(m_spnames[i], spname);
     }
@@ -82,7 +88,8 @@ KMCGasPoint::KMCGasPoint(const KMCGasPoint &gp):
 				m_data(),
 				m_gasprof(NULL),
 				m_spnames(),
-				m_prof_in()
+				m_prof_in(),
+				m_cursor(0)
 {
     *this = gp;
 }
@@ -119,17 +126,20 @@ void KMCGasPoint::initData() {
 //! Interpolate data
 void KMCGasPoint::Interpolate(double t, double fact) {
     // get time point after t
-    GasProfile::const_iterator j = LocateGasPoint(*m_gasprof, t);
+    GasProfile::const_iterator j = m_gasprof->begin() + locate(t);
     if(j == m_gasprof->begin() || j == m_gasprof->end()-1) {
+        const double *const xj = j->Gas.RawData();
         m_data[Time] = j->Time;
         m_data[T] = j->Gas.Temperature();
         m_data[P] = j->Gas.Pressure();
         for(int i=H2; i<(m_total-2); i++) { // exclude P & None
-            m_data[i] = j->Gas.RawData()[m_prof_in[i]];
+            m_data[i] = xj[m_prof_in[i]];
             m_data[i] *= fact;
         }
     }else {
         GasProfile::const_iterator i = j; --i;
+        const double *const xi = i->Gas.RawData();
+        const double *const xj = j->Gas.RawData();
         double dt_ij = j->Time - i->Time;
         double dt = t - i->Time;
         double wx = dt/dt_ij;
@@ -138,13 +148,44 @@ void KMCGasPoint::Interpolate(double t, double fact) {
         m_data[T] = i->Gas.Temperature()*wy + j->Gas.Temperature()*wx;
         m_data[P] = i->Gas.Pressure()*wy + j->Gas.Pressure()*wx;
         for(int k=H2; k<(m_total-2); k++) { // exclude P & None
-            m_data[k] = i->Gas.RawData()[m_prof_in[k]]*wy + j->Gas.RawData()[m_prof_in[k]]*wx;
+            m_data[k] = xi[m_prof_in[k]]*wy + xj[m_prof_in[k]]*wx;
             m_data[k] *= fact;
         }
     }
     ConvertMoleFrac();
 }
 
+/*!
+ * Gives the same point as LocateGasPoint, but the search starts from the
+ * point found by the previous call.  KMC time only moves forward within
+ * KMCSimulator::updatePAH, so this is usually the same point or the next
+ * one.  The search works in both directions, so it is also correct when
+ * the time goes back at the start of the next update, or when the
+ * profile has been refilled.
+ *
+ * @param[in]    t       Time
+ *
+ * @return       Index of the first point after t, or of the last point
+ */
+size_t KMCGasPoint::locate(double t) {
+    const GasProfile &prof = *m_gasprof;
+    if (prof.empty())
+        throw std::runtime_error("Gas profile is empty "
+                                 "(Sweep::KMC_ARS::KMCGasPoint::Interpolate).");
+
+    size_t j = std::min(m_cursor, prof.size() - 1);
+    while ((j > 0) && GasPoint::IsAfterTime(prof[j-1], t))
+        --j;
+    while ((j < prof.size()) && !GasPoint::IsAfterTime(prof[j], t))
+        ++j;
+
+    // return the last element if no point is after t
+    if (j == prof.size())
+        j = prof.size() - 1;
+    m_cursor = j;
+    return j;
+}
+
 //! Convert Mole frac to Conc
 void KMCGasPoint::ConvertMoleFrac() {
     double factor = m_data[P]/(R*m_data[T]*1e6); // convert to mol/cm^3
@@ -162,6 +203,7 @@ KMCGasPoint& KMCGasPoint::operator=(const KMCGasPoint& gp) {
     m_gasprof = gp.m_gasprof;
     m_spnames = gp.m_spnames;
     m_prof_in = gp.m_prof_in;
+    m_cursor = gp.m_cursor;
     return *this;
     } else return *this;
 }
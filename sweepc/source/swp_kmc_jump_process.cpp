@@ -60,6 +60,8 @@ JumpProcess::JumpProcess():
 	m_rxnvector0p12(),
 	m_rxnvector1(),
 	m_r(),
+	m_r_rxnv(NULL),
+	m_r_gas(),
 	m_rate(0.0),
 	m_name(""),
 	m_ID(0)
@@ -72,6 +74,8 @@ JumpProcess::JumpProcess(const JumpProcess& p):
 	m_rxnvector0p12(),
 	m_rxnvector1(),
 	m_r(),
+	m_r_rxnv(NULL),
+	m_r_gas(),
 	m_rate(p.m_rate),
 	m_name(p.m_name),
 	m_ID(p.m_ID) {
@@ -97,12 +101,37 @@ void JumpProcess::addReaction(std::vector<Sweep::KMC_ARS::Reaction>& rxnv, const
     rxnv.push_back(rxn);
 }
 //! Calculate rates of each elementary reaction
-void JumpProcess::calculateElemRxnRate(std::vector<Sweep::KMC_ARS::Reaction>& rxnv, const KMCGasPoint& gp/*, const double t_now*/) {
+/*!
+ * The elementary rates depend only on the gas point, so they are kept
+ * if the same reactions were last evaluated for the same temperature,
+ * pressure and concentrations.
+ *
+ * @param[in]    rxnv    Elementary reactions for the current pressure
+ * @param[in]    gp      Gas point
+ *
+ * @return       True if the rates were recalculated
+ */
+bool JumpProcess::calculateElemRxnRate(std::vector<Sweep::KMC_ARS::Reaction>& rxnv, const KMCGasPoint& gp/*, const double t_now*/) {
+	bool same = (m_r_rxnv == &rxnv) && (m_r.size() == rxnv.size());
+	m_r_gas.resize(KMCGasPoint::m_total, 0.0);
+	for (int k = KMCGasPoint::T; k != KMCGasPoint::m_total; ++k) {
+		if (m_r_gas[k] != gp[k]) {
+			m_r_gas[k] = gp[k];
+			same = false;
+		}
+	}
+	if (same) return false;
 
 	m_r.resize(rxnv.size(), 0.0);
 	for (size_t i(0); i != rxnv.size(); ++i) {
 		m_r[i] = rxnv[i].getRate(gp);
 	}
+	m_r_rxnv = &rxnv;
+	return true;
+}
+//! Adds the site types whose counts the jump rate depends on
+void JumpProcess::getSiteDependencies(std::vector<kmcSiteType>& types) const {
+    types.push_back(m_sType);
 }
 //! Calculates jump process rates and store (for Pressures 0.0267, 0.12 & 1 atm; defined in derived classes)
 double JumpProcess::setRate0p0267(const KMCGasPoint& gp, PAHProcess& pah_st/*, const double& time_now*/){
@@ -45,10 +45,10 @@
 #include "swp_kmc_mech.h"
 #include "swp_params.h"
 
-#include "choose_index.hpp"
 #include "string_functions.h"
 
 #include <boost/random/uniform_01.hpp>
+#include <algorithm>
 
 using namespace std;
 using namespace Sweep;
@@ -64,6 +64,7 @@ KMCMechanism::KMCMechanism() {
     m_rates = std::vector<double>(m_jplist.size(),0);
     m_totalrate = 0;
     isACopy = false;
+    buildDependencies();
 }
 //! Copy Constructor
 KMCMechanism::KMCMechanism(KMCMechanism& m) {
@@ -71,6 +72,12 @@ KMCMechanism::KMCMechanism(KMCMechanism& m) {
     m_rates = m.m_rates;
     m_totalrate = m.m_totalrate;
     isACopy = true;
+    m_ratetree = m.m_ratetree;
+    m_deptypes = m.m_deptypes;
+    m_deps = m.m_deps;
+    m_depcounts = m.m_depcounts;
+    m_gasdata = m.m_gasdata;
+    m_regime = m.m_regime;
 }
 //! Destructor
 KMCMechanism::~KMCMechanism() {
@@ -88,6 +95,27 @@ KMCMechanism::~KMCMechanism() {
 //! Load processes from process list
 void KMCMechanism::loadProcesses(std::vector<JumpProcess*> (*jp)()) {//how##
     m_jplist = jp();
+    m_rates.assign(m_jplist.size(), 0);
+    buildDependencies();
+}
+//! Find the site types each jump process depends on
+void KMCMechanism::buildDependencies() {
+    m_deptypes.clear();
+    m_deps.assign(m_jplist.size(), std::vector<size_t>());
+    for (size_t i = 0; i != m_jplist.size(); ++i) {
+        std::vector<kmcSiteType> types;
+        m_jplist[i]->getSiteDependencies(types);
+        for (size_t j = 0; j != types.size(); ++j) {
+            size_t k = std::find(m_deptypes.begin(), m_deptypes.end(), types[j]) - m_deptypes.begin();
+            if (k == m_deptypes.size())
+                m_deptypes.push_back(types[j]);
+            m_deps[i].push_back(k);
+        }
+    }
+    m_depcounts.clear();
+    m_gasdata.clear();
+    m_regime = -1;
+    m_ratetree.Assign(m_rates);
 }
 // KMC Algorithm and Read Processes
 ////! Calculates each jump rates and stores in a vector
@@ -113,7 +141,8 @@ void KMCMechanism::loadProcesses(std::vector<JumpProcess*> (*jp)()) {//how##
 ChosenProcess KMCMechanism::chooseReaction(rng_type &rng) const {
     // chooses index from a vector of weights (double number in this case) randomly
     boost::uniform_01<rng_type &, double> uniformGenerator(rng);
-    size_t ind = chooseIndex<double>(m_rates, uniformGenerator);
+    int ind = m_ratetree.Select(uniformGenerator());
+    if (ind < 0) ind = 0;
     return ChosenProcess(m_jplist[ind], ind);
 }
 typedef Sweep::KMC_ARS::KMCGasPoint sp;
@@ -171,32 +200,82 @@ std::vector<JumpProcess*> KMCMechanism::obtainJumpProcess(){
 }
 
 //! Calculates jump rate for each jump process
+/*!
+ * A jump rate depends on the gas point, through the elementary reaction
+ * rates, and on the counts of a few site types.  A jump process changes the
+ * counts of only some site types, so the rates are recalculated only for the
+ * processes which depend on a site type whose count has changed, unless the
+ * gas point or the pressure regime has changed.
+ *
+ * @param[in]    gp      Gas point
+ * @param[in]    st      PAH whose jump rates are calculated
+ * @param[in]    t       Time
+ */
 void KMCMechanism::calculateRates(const KMCGasPoint& gp, 
                     PAHProcess& st, 
                     const double& t) {
-    double temp=0;
     double pressure = gp[gp.P]/1e5;
     // Choose suitable mechanism according to P
-    if(pressure > 0.5 && pressure <= 5) { // mechanism at 1 atm 
-        for(int i = 0; i!= (int) m_jplist.size() ; i++) {
-            (m_jplist[i])->calculateElemRxnRate((m_jplist[i])->getVec1(), gp);
-            m_rates[i] = (m_jplist[i])->setRate1(gp, st/*, t*/);
-            temp += m_rates[i];
+    int regime;
+    if(pressure > 0.5 && pressure <= 5) regime = 2; // mechanism at 1 atm
+    else if(pressure > 0.01 && pressure <= 0.07) regime = 0; // mechanism at 0.0267atm
+    else if(pressure > 0.07 && pressure <= 0.5) regime = 1; // mechanism at 0.12atm
+    else {
+        std::cout<<"ERROR: No reaction mechanism for this pressure condition.\n";
+        m_regime = -1;
+        m_totalrate = 1e-20;
+        return;
+    }
+
+    // Everything is recalculated if the gas point has changed.
+    bool all = (regime != m_regime) || (m_gasdata.size() != (size_t) KMCGasPoint::m_total);
+    m_gasdata.resize(KMCGasPoint::m_total, 0.0);
+    for (int k = KMCGasPoint::T; k != KMCGasPoint::m_total; ++k) {
+        if (m_gasdata[k] != gp[k]) {
+            m_gasdata[k] = gp[k];
+            all = true;
         }
-    }else if(pressure > 0.01 && pressure <= 0.07) { // mechanism at 0.0267atm
-        for(int i = 0; i!= (int) m_jplist.size() ; i++) {
-            (m_jplist[i])->calculateElemRxnRate((m_jplist[i])->getVec0p0267(), gp);
-            m_rates[i] = (m_jplist[i])->setRate0p0267(gp, st/*, t*/);
-            temp += m_rates[i];
+    }
+    m_regime = regime;
+
+    // Find the site types whose counts have changed.
+    std::vector<bool> changed(m_deptypes.size(), all);
+    if (m_depcounts.size() != m_deptypes.size()) {
+        m_depcounts.assign(m_deptypes.size(), 0);
+        changed.assign(m_deptypes.size(), true);
+    }
+    for (size_t k = 0; k != m_deptypes.size(); ++k) {
+        unsigned int n = st.getSiteCount(m_deptypes[k]);
+        if (n != m_depcounts[k]) {
+            m_depcounts[k] = n;
+            changed[k] = true;
         }
-    }else if(pressure > 0.07 && pressure <= 0.5) { // mechanism at 0.12atm
-        for(int i = 0; i!= (int) m_jplist.size() ; i++) {
-            (m_jplist[i])->calculateElemRxnRate((m_jplist[i])->getVec0p12(), gp);
-            m_rates[i] = (m_jplist[i])->setRate0p12(gp, st/*, t*/);
-            temp += m_rates[i];
+    }
+
+    for(int i = 0; i!= (int) m_jplist.size() ; i++) {
+        bool update = all;
+        for (size_t j = 0; !update && j != m_deps[i].size(); ++j)
+            update = changed[m_deps[i][j]];
+        if (!update) continue;
+
+        // The elementary rates are kept by the jump process for the
+        // last gas point it saw, so this is cheap if they are current.
+        JumpProcess &jp = *m_jplist[i];
+        if (regime == 2) {
+            jp.calculateElemRxnRate(jp.getVec1(), gp);
+            m_rates[i] = jp.setRate1(gp, st/*, t*/);
+        } else if (regime == 0) {
+            jp.calculateElemRxnRate(jp.getVec0p0267(), gp);
+            m_rates[i] = jp.setRate0p0267(gp, st/*, t*/);
+        } else {
+            jp.calculateElemRxnRate(jp.getVec0p12(), gp);
+            m_rates[i] = jp.setRate0p12(gp, st/*, t*/);
         }
-    }else std::cout<<"ERROR: No reaction mechanism for this pressure condition.\n";
+        m_ratetree.Update(i, m_rates[i]);
+    }
+
     // update total rates
+    double temp = m_ratetree.Total();
     if (temp < 1e-20) temp = 1e-20;
     m_totalrate = temp;
 }
@@ -471,6 +550,11 @@ double PH_benz::setRate0p12(const KMCGasPoint& gp, PAHProcess& pah_st/*, const d
 double PH_benz::setRate1(const KMCGasPoint& gp, PAHProcess& pah_st/*, const double& time_now*/) {
     return setRate0p0267(gp, pah_st);
 }
+// The rate also depends on whether there are R5 sites
+void PH_benz::getSiteDependencies(std::vector<kmcSiteType>& types) const {
+    types.push_back(m_sType);
+    types.push_back(R5);
+}
 // 
 // ************************************************************
 // ID5- R6 desorption at FE (AR8 in Matlab)
@@ -594,10 +594,8 @@ Spointer PAHProcess::chooseRandomSite(std::vector<kmcSiteType> vtype, rng_type &
 Cpointer PAHProcess::addC() {
     Cpointer cb;
     // Create new carbon atom at memory pointed by h
-    cb = new Carbon;
-    if(!m_pah->m_carbonList.insert(cb).second)
-        std::cout<<"ERROR: ADDING SAME CARBON POINTER TO SET\n";
-    m_pah->m_cpositions.insert(cb->coords); // store coordinates
+    cb = m_pah->m_carbonList.create();
+    m_pah->m_cpositions.insert(cb->coords, cb); // store coordinates
     addCount(1,0); // add a C count
     return cb;
 }
@@ -610,16 +608,14 @@ Cpointer PAHProcess::addC() {
 Cpointer PAHProcess::addC(Cpointer C_1, angletype angle1, angletype angle2, bool bulk) {
     Cpointer cb;
     // Create new carbon atom
-    cb = new Carbon;
+    cb = m_pah->m_carbonList.create();
     // Set details of new Carbon
     cb->C1 = C_1;
     cb->C2 = C_1->C2;
     cb->bondAngle1 = normAngle(angle2); // convert angle to +ve/-ve form
     // set new coordinates and store
     cb->coords = jumpToPos(C_1->coords, angle1);
-    if(!m_pah->m_carbonList.insert(cb).second)
-        std::cout<<"ERROR: ADDING SAME CARBON POINTER TO SET\n";
-    m_pah->m_cpositions.insert(cb->coords);
+    m_pah->m_cpositions.insert(cb->coords, cb);
     // Edit details of connected carbon(s)
     if(C_1->C2 != NULL) {
         // change member pointer of original neighbour of C_1
@@ -641,16 +637,14 @@ Cpointer PAHProcess::addC(Cpointer C_1, angletype angle1, angletype angle2, bool
 Cpointer PAHProcess::bridgeC(Cpointer C_1) {
     Cpointer cb;
     // Create new carbon atom
-    cb = new Carbon;
+    cb = m_pah->m_carbonList.create();
     // Set details of new Carbon
     cb->C3 = C_1;
     cb->bondAngle2 = normAngle(C_1->bondAngle2 - 180); // opposite direction of C_1->bondAngle2
     cb->bridge = true;
     // set new coordinates and store
     cb->coords = jumpToPos(C_1->coords, C_1->bondAngle2);
-    if(!m_pah->m_carbonList.insert(cb).second)
-        std::cout<<"ERROR: ADDING SAME CARBON POINTER TO SET\n";
-    m_pah->m_cpositions.insert(cb->coords);
+    m_pah->m_cpositions.insert(cb->coords, cb);
     // Set details of C_1
     C_1->bridge = true;
     C_1->C3 = cb;
@@ -703,7 +697,7 @@ void PAHProcess::removeC(Cpointer C_1, bool bulk) {
     }else if(C_1 == m_pah->m_clast) {
         m_pah->m_clast = C_1->C1;
     }
-    if(m_pah->m_cpositions.find(C_1->coords)== m_pah->m_cpositions.end()) {
+    if(!m_pah->m_cpositions.count(C_1->coords)) {
         cout<<"ERROR: removeC: coordinates ("<<C_1->coords.first<<','<<C_1->coords.second<<") not in m_pah->m_cpositions!\n";
         cout<<"Coordinates of nearby 5 C atoms:\n";
         Cpointer now = C_1->C1->C1->C1->C1->C1;
@@ -728,10 +722,9 @@ void PAHProcess::removeC(Cpointer C_1, bool bulk) {
         C_1->C3->bridge = false;
     }
     // Remove coordinates of C from m_pah->m_cpositions
-    m_pah->m_cpositions.erase(m_pah->m_cpositions.find(C_1->coords));
-    // delete Carbon object
-    delete C_1;
-    if(m_pah->m_carbonList.erase(C_1) == 0)
+    m_pah->m_cpositions.erase(C_1->coords);
+    // release Carbon object
+    if(!m_pah->m_carbonList.release(C_1))
         std::cout<<"ERROR: removeC: NOT ERASING ANY POINTERS!\n";
     if(!bulk) { // if desorption, decrease C count accordingly
         addCount(-1, 0); 
@@ -1557,12 +1550,9 @@ Cpointer PAHProcess::drawType2Site(Cpointer Cnow, int bulkC) {
 
 //! Finds C atom with specific coordinates
 Cpointer PAHProcess::findC(cpair coordinates) {
-    for(Ccontainer::iterator i=m_pah->m_carbonList.begin();
-        i != m_pah->m_carbonList.end(); ++i) {
-            if((*i)->coords == coordinates)
-                return (*i);
-    }
-    return NULLC;
+    Cpointer C = m_pah->m_cpositions.find(coordinates);
+    if(C == NULL) return NULLC;
+    return C;
 }
 
 // Check to validate if coordinates of C matches bond angles
@@ -108,9 +108,7 @@ PAHStructure::~PAHStructure() {
 
 //! Remove all data and release any memory
 void PAHStructure::clear() {
-    for(set<Cpointer>::iterator i=m_carbonList.begin(); i!=m_carbonList.end(); i++)
-        delete *i;
-    // clear all data
+    // clear all data and free the carbon storage
     m_carbonList.clear();
     m_siteMap.clear();
     m_siteList.clear();
@@ -257,8 +255,10 @@ void PAHStructure::WriteCposition(std::ostream &out) const
 {
 	double val = 0.0;
 
-	std::set<cpair>::iterator itEnd = m_cpositions.end();
-	for (std::set<cpair>::iterator it = m_cpositions.begin(); it != itEnd; ++it)
+	std::vector<cpair> positions;
+	m_cpositions.keys(positions);
+	std::vector<cpair>::iterator itEnd = positions.end();
+	for (std::vector<cpair>::iterator it = positions.begin(); it != itEnd; ++it)
 	{
 		val = (*it).first;
 		out.write((char*)&val, sizeof(val));
@@ -271,7 +271,7 @@ std::list<Site> PAHStructure::GetSiteList() const {
 	return m_siteList;
 }
 
-std::map<kmcSiteType, svector> PAHStructure::GetSiteMap() const {
+const SiteMap &PAHStructure::GetSiteMap() const {
 	return m_siteMap;
 }
 // the size for m_cpositions is required obviously, otherwise, the codes will not know when to stop
@@ -291,7 +291,7 @@ void PAHStructure::ReadCposition(std::istream &in, const int size)
         m_second = (int)val;
 
         position = make_pair(m_first, m_second);
-        m_cpositions.insert(m_cpositions.end(), position);
+        m_cpositions.insert(position);
     }
 }
 
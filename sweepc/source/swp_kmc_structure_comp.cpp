@@ -2,6 +2,7 @@
 #include "swp_kmc_structure_comp.h"
 #include <list>
 #include <cmath>
+#include <algorithm>
 
 using namespace Sweep::KMC_ARS;
 using namespace std;
@@ -14,9 +15,178 @@ Carbon::Carbon(): C1(NULLC),
     A(0),
     bondAngle1(0),
     bondAngle2(0),
-    coords(0,0)
+    coords(0,0),
+    index(0)
 {
 }
 
 Carbon::~Carbon(){
 }
+
+// CARBON LIST.
+
+CarbonList::CarbonList(): m_capacity(0)
+{
+}
+
+CarbonList::~CarbonList()
+{
+    clear();
+}
+
+Cpointer CarbonList::create()
+{
+    if(m_free.empty()) {
+        // double the storage, as the atoms cannot move to a larger block
+        unsigned int n = m_capacity;
+        if(n == 0) n = FirstBlockSize;
+        Cpointer block = new Carbon[n];
+        m_blocks.push_back(block);
+        m_capacity += n;
+        // hand out the atoms of the block in order
+        for(unsigned int i=n; i!=0; --i)
+            m_free.push_back(block + i - 1);
+    }
+    Cpointer c = m_free.back();
+    m_free.pop_back();
+    *c = Carbon();
+    c->index = (unsigned int) m_live.size();
+    m_live.push_back(c);
+    return c;
+}
+
+bool CarbonList::release(Cpointer c)
+{
+    if(c == NULL || c->index >= m_live.size() || m_live[c->index] != c)
+        return false;
+    // move the last atom into the free position
+    m_live[c->index] = m_live.back();
+    m_live[c->index]->index = c->index;
+    m_live.pop_back();
+    m_free.push_back(c);
+    return true;
+}
+
+void CarbonList::clear()
+{
+    for(size_t i=0; i!=m_blocks.size(); ++i)
+        delete [] m_blocks[i];
+    std::vector<Cpointer>().swap(m_blocks);
+    std::vector<Cpointer>().swap(m_live);
+    std::vector<Cpointer>().swap(m_free);
+    m_capacity = 0;
+}
+
+// COORDINATE MAP.
+
+CoordMap::CoordMap(): m_size(0)
+{
+}
+
+size_t CoordMap::home(const cpair &c) const
+{
+    unsigned int h = (unsigned int) c.first * 0x9E3779B1u;
+    h ^= (unsigned int) c.second * 0x85EBCA77u;
+    h ^= h >> 15;
+    return h & (m_table.size() - 1);
+}
+
+size_t CoordMap::locate(const cpair &c) const
+{
+    const size_t mask = m_table.size() - 1;
+    size_t i = home(c);
+    while(m_table[i].used && m_table[i].coords != c)
+        i = (i + 1) & mask;
+    return i;
+}
+
+size_t CoordMap::count(const cpair &c) const
+{
+    if(m_table.empty()) return 0;
+    return m_table[locate(c)].used ? 1 : 0;
+}
+
+Cpointer CoordMap::find(const cpair &c) const
+{
+    if(m_table.empty()) return NULL;
+    const Entry &e = m_table[locate(c)];
+    return e.used ? e.C : NULL;
+}
+
+bool CoordMap::insert(const cpair &c, Cpointer C)
+{
+    if(m_table.empty()) grow();
+    size_t i = locate(c);
+    if(m_table[i].used) return false;
+    // keep the table at most half full
+    if(2 * (m_size + 1) > m_table.size()) {
+        grow();
+        i = locate(c);
+    }
+    m_table[i].coords = c;
+    m_table[i].C = C;
+    m_table[i].used = true;
+    ++m_size;
+    return true;
+}
+
+size_t CoordMap::erase(const cpair &c)
+{
+    if(m_table.empty()) return 0;
+    const size_t mask = m_table.size() - 1;
+    size_t i = locate(c);
+    if(!m_table[i].used) return 0;
+    // move back the entries whose search passes through the freed slot
+    size_t j = i;
+    while(true) {
+        j = (j + 1) & mask;
+        if(!m_table[j].used) break;
+        const size_t k = home(m_table[j].coords);
+        if(((j - k) & mask) >= ((j - i) & mask)) {
+            m_table[i] = m_table[j];
+            i = j;
+        }
+    }
+    m_table[i].used = false;
+    m_table[i].C = NULL;
+    --m_size;
+    return 1;
+}
+
+void CoordMap::clear()
+{
+    std::vector<Entry>().swap(m_table);
+    m_size = 0;
+}
+
+void CoordMap::keys(std::vector<cpair> &out) const
+{
+    out.clear();
+    out.reserve(m_size);
+    for(size_t i=0; i!=m_table.size(); ++i)
+        if(m_table[i].used) out.push_back(m_table[i].coords);
+    std::sort(out.begin(), out.end());
+}
+
+bool CoordMap::operator==(const CoordMap &rhs) const
+{
+    if(m_size != rhs.m_size) return false;
+    for(size_t i=0; i!=m_table.size(); ++i)
+        if(m_table[i].used && !rhs.count(m_table[i].coords)) return false;
+    return true;
+}
+
+void CoordMap::grow()
+{
+    Entry e;
+    e.coords = cpair(0, 0);
+    e.C = NULL;
+    e.used = false;
+    size_t n = 2 * m_table.size();
+    if(n == 0) n = FirstTableSize;
+    std::vector<Entry> old(n, e);
+    old.swap(m_table);
+    m_size = 0;
+    for(size_t i=0; i!=old.size(); ++i)
+        if(old[i].used) insert(old[i].coords, old[i].C);
+}
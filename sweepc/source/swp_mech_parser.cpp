@@ -390,6 +390,15 @@ void MechParser::readV1(CamXML::Document &xml, Sweep::Mechanism &mech)
 		mech.SetCoagulateInList(false);
     }
 
+    // Number of threads over which the LPDA particle updates are distributed.
+    str = particleXML->GetAttributeValue("lpda-threads");
+    if (str != "") {
+        int nthreads = (int)cdble(str);
+        if (nthreads < 1)
+            throw std::runtime_error("LPDA thread count must be positive. (Sweep::MechParser::readV1)");
+        mech.SetLPDAThreadCount(nthreads);
+    }
+
     //! Check whether to track the distance betweeen the centres of primary
     //! particles or the coordinates of the primary particles, but this only
     //! applies to the binary tree and PAH-KMC (and maybe surface-volume)
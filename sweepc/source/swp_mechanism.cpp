@@ -56,6 +56,7 @@
 #include <boost/random/uniform_01.hpp>
 #include <boost/random/lognormal_distribution.hpp>
 #include <boost/random/variate_generator.hpp>
+#include <boost/functional/hash.hpp>
 
 #include "string_functions.h"
 #include "swp_particle.h"
@@ -73,7 +74,8 @@ using namespace Strings;
 // Default constructor.
 Mechanism::Mechanism(void)
 : m_anydeferred(false), m_icoag(-1), m_termcount(0), m_processcount(0),
-m_hybrid(false), m_coagulate_in_list(false), m_heatprod(0) //ljx
+m_hybrid(false), m_coagulate_in_list(false), m_heatprod(0), //ljx
+m_lpda_threads(1)
 {
 }
 
@@ -111,6 +113,7 @@ Mechanism &Mechanism::operator=(const Mechanism &rhs)
         // Particle-number/particle model flags
         m_hybrid = rhs.m_hybrid;
         m_coagulate_in_list = rhs.m_coagulate_in_list;
+        m_lpda_threads = rhs.m_lpda_threads;
 
 		m_i_particle_species = rhs.m_i_particle_species;
 
@@ -588,6 +591,26 @@ double Mechanism::CalcRateTerms(double t, const Cell &sys, const Geometry::Local
 // Get total rates of non-deferred processes.  Returns the sum
 // of all rates.
 double Mechanism::CalcJumpRateTerms(double t, const Cell &sys, const Geometry::LocalGeometry1d& local_geom, fvector &terms) const
+{
+    return CalcJumpRateTerms(t, sys, local_geom, terms, true);
+}
+
+/*!
+ * As above, except that the inception terms already in terms are kept if
+ * inceptions is false.  Inception rates depend only on the gas phase and the
+ * sample volume, so a caller which knows that neither has changed since the
+ * terms were last calculated can skip them.
+ *
+ *@param[in]    t           Time at which to calculate the rates
+ *@param[in]    sys         System for which rates are to be calculated
+ *@param[in]    local_geom  Information on location of surrounding cells
+ *@param[in,out] terms      Vector to fill with the terms contributing to the summed rate
+ *@param[in]    inceptions  Recalculate the inception terms?
+ *
+ *@return   The total rate of all non-deferred processes
+ */
+double Mechanism::CalcJumpRateTerms(double t, const Cell &sys, const Geometry::LocalGeometry1d& local_geom,
+                                    fvector &terms, bool inceptions) const
 {
     // This routine only calculates the rates of those processes which are
     // not deferred.  The rate terms of deferred processes are returned
@@ -602,7 +625,11 @@ double Mechanism::CalcJumpRateTerms(double t, const Cell &sys, const Geometry::L
     // Get rates of inception processes.
     IcnPtrVector::const_iterator ii;
     for (ii=m_inceptions.begin(); ii!=m_inceptions.end(); ++ii) {
-        sum += (*ii)->RateTerms(t, sys, local_geom, iterm);
+        if (inceptions) {
+            sum += (*ii)->RateTerms(t, sys, local_geom, iterm);
+        } else {
+            for (unsigned int j=0; j!=(*ii)->TermCount(); ++j) {sum += *(iterm++);}
+        }
     }
 
     // Query other processes for their rates.
@@ -1007,21 +1034,42 @@ void Mechanism::LPDA(double t, Cell &sys, rng_type &rng) const
 
 		PartPtrVector overflow;
 
-        // Perform deferred processes on all particles individually.
-		int oldweight;
 		Ensemble::iterator i;
 		int ind = 0;
-        for (i=sys.Particles().begin(); i!=sys.Particles().end(); ++i) {
-			oldweight = (*(*i)).getStatisticalWeight();
-            UpdateParticle(*(*i), sys, t, ind, rng, overflow); 
-			if (oldweight != (*(*i)).getStatisticalWeight()){
-				sys.Particles().Update(ind);
-			}
-			ind++;
+
+        // Collect the gas-phase changes of the particle updates and apply
+        // them in one go at the end of the pass.
+        sys.DeferGasChanges(m_lpda_threads);
+
+        if (canUpdateInParallel(sys)) {
+            // Update the particles concurrently.  The binary tree is not
+            // updated per particle, the changed particles are marked dirty
+            // once all threads have finished.
+            std::vector<char> changed;
+            parallelUpdateParticles(t, sys, rng, overflow, changed);
+            for (unsigned int j = 0; j != changed.size(); ++j) {
+                if (changed[j])
+                    sys.Particles().MarkDirty(j);
+            }
+        } else {
+            // Perform deferred processes on all particles individually.
+            int oldweight;
+            for (i=sys.Particles().begin(); i!=sys.Particles().end(); ++i) {
+                oldweight = (*(*i)).getStatisticalWeight();
+                if (UpdateParticle(*(*i), sys, t, ind, rng, overflow))
+                    sys.Particles().MarkDirty(ind);
+                if (oldweight != (*(*i)).getStatisticalWeight()){
+                    sys.Particles().Update(ind);
+                }
+                ind++;
+            }
         }
-        // aab64: Could the particle updates be made more efficient here using OpenMP parallelization? 
 
-		// Now remove any invalid particles and update the ensemble.
+        sys.ApplyGasChanges();
+
+		// Now remove any invalid particles and update the ensemble.  This
+		// refreshes the tree leaves of the particles marked dirty, or
+		// rebuilds the tree if too many have changed.
 		sys.Particles().RemoveInvalids();
 
 		if (sys.ParticleModel()->Components(0)->WeightedPAHs() && AggModel() == AggModels::PAH_KMC_ID){
@@ -1040,7 +1088,7 @@ void Mechanism::LPDA(double t, Cell &sys, rng_type &rng) const
 							int oldweight1 = (*sys.Particles().At(indpart)).getStatisticalWeight();
 							int oldweight2 = (*sys.Particles().At(ind)).getStatisticalWeight();
 							(*sys.Particles().At(indpart)).setStatisticalWeight(oldweight1 + oldweight2);
-							sys.Particles().Update(indpart);
+							sys.Particles().MarkDirty(indpart);
 							//Invalidate the PAH (and hence the particle) by setting statistical weight to negative 1
 							(*sys.Particles().At(ind)).setStatisticalWeight(-1.0);
 							count++;
@@ -1094,6 +1142,84 @@ void Mechanism::LPDA(double t, Cell &sys, rng_type &rng) const
     }
 }
 
+// Number of particles updated with each random number stream in the
+// parallel LPDA.  The streams are tied to blocks of particles rather
+// than to threads, so the random numbers do not depend on the thread count.
+static const int lpda_block_size = 256;
+
+/*!
+ * The parallel update is only used for models whose particle updates
+ * touch nothing but the particle itself and the deferred gas-phase
+ * changes.  PAH-KMC updates share the KMC simulator and may change the
+ * ensemble.
+ *
+ *@param[in]        sys         System containing particles to update
+ *
+ *@return       True if the particles of sys may be updated concurrently
+ */
+bool Mechanism::canUpdateInParallel(const Cell &sys) const
+{
+    return (m_lpda_threads > 1) &&
+           (sys.ParticleCount() > (unsigned int)lpda_block_size) &&
+           (AggModel() != AggModels::PAH_KMC_ID);
+}
+
+/*!
+ * Performs linear process updates on all particles in a system, with
+ * blocks of particles distributed over threads.  Each block has its own
+ * random number stream seeded from rng, and its own overflow vector.
+ * Gas-phase changes must be deferred (see Cell::DeferGasChanges) so that
+ * each thread adds them to its own buffer.  The ensemble binary tree is
+ * not updated.
+ *
+ *@param[in]        t           Time upto which particles to be updated
+ *@param[in,out]    sys         System containing particles to update
+ *@param[in,out]    rng         Random number generator
+ *@param[out]       overflow    Particles created by the updates
+ *@param[out]       changed     Non-zero for each particle that may have changed
+ *
+ *@exception    std::runtime_error  A particle update failed
+ */
+void Mechanism::parallelUpdateParticles(double t, Cell &sys, rng_type &rng,
+                                        PartPtrVector &overflow,
+                                        std::vector<char> &changed) const
+{
+    const int n = (int)sys.ParticleCount();
+    const int nblocks = (n + lpda_block_size - 1) / lpda_block_size;
+    changed.assign(n, 0);
+
+    // Seed for the block streams, drawn once from the master stream.
+    const size_t seed = rng();
+
+    std::vector<PartPtrVector> blockoverflow(nblocks);
+    std::vector<std::string> errors(nblocks);
+
+    // A static schedule keeps the order in which each thread's gas-phase
+    // changes are summed the same from one call to the next.
+    #pragma omp parallel for schedule(static, 1) num_threads(m_lpda_threads)
+    for (int b = 0; b < nblocks; ++b) {
+        size_t blockseed = seed;
+        boost::hash_combine(blockseed, b);
+        rng_type blockrng(static_cast<unsigned int>(blockseed));
+
+        const int end = min(n, (b + 1) * lpda_block_size);
+        try {
+            for (int ind = b * lpda_block_size; ind < end; ++ind) {
+                changed[ind] = UpdateParticle(*sys.Particles().At(ind), sys, t, ind,
+                                              blockrng, blockoverflow[b]);
+            }
+        } catch (std::exception &e) {
+            errors[b] = e.what();
+        }
+    }
+
+    for (int b = 0; b < nblocks; ++b) {
+        if (!errors[b].empty())
+            throw std::runtime_error(errors[b] + " (Sweep, Mechanism::parallelUpdateParticles).");
+        overflow.insert(overflow.end(), blockoverflow[b].begin(), blockoverflow[b].end());
+    }
+}
+
 // LINEAR PROCESS DEFERMENT ALGORITHM #2: Hybrid particle-number/particle model
 // Applies surface updates to particles tracked in the particle-number list
 // Note: this method is less optimal than the one commented out below it, but
@@ -1371,9 +1497,16 @@ unsigned int Mechanism::SetRandomParticle(Sweep::Ensemble &ens, double t, double
  *@param[in,out]    sys         System containing particle to update
  *@param[in]        t           Time upto which particle to be updated
  *@param[in,out]    rng         Random number generator
+ *
+ *@return       True if the particle may have changed
  */
-void Mechanism::UpdateParticle(Particle &sp, Cell &sys, double t, int ind, rng_type &rng, PartPtrVector &overflow) const
+bool Mechanism::UpdateParticle(Particle &sp, Cell &sys, double t, int ind, rng_type &rng, PartPtrVector &overflow) const
 {
+    // Set when the particle is, or may have been, changed.  A particle
+    // for which no deferred event fires and which is not sintered keeps
+    // its tree leaf.
+    bool changed = false;
+
     // Deal with the growth of the PAHs
     if (AggModel() == AggModels::PAH_KMC_ID)
     {
@@ -1383,6 +1516,7 @@ void Mechanism::UpdateParticle(Particle &sp, Cell &sys, double t, int ind, rng_t
         sp.SetTime(t);
 
 		if (dt > 0){ //Only do this if dt is greater than 0
+			changed = true;
 
 			// If the agg model is PAH_KMC_ID then all the primary
 			// particles must be PAHPrimary.
@@ -1427,6 +1561,7 @@ void Mechanism::UpdateParticle(Particle &sp, Cell &sys, double t, int ind, rng_t
         double dt;
         dt = t - sp.LastUpdateTime();
         sp.SetTime(t);
+        changed = true;
 
         sp.Sinter(dt, sys, m_sint_model, rng, sp.getStatisticalWeight());
 
@@ -1467,6 +1602,7 @@ void Mechanism::UpdateParticle(Particle &sp, Cell &sys, double t, int ind, rng_t
                          if (num > 0) {
                              // Do the process to the particle.
                              (*i)->Perform(t, sys, sp, rng, num);
+                             changed = true;
                          }
                     }
                 }
@@ -1475,11 +1611,13 @@ void Mechanism::UpdateParticle(Particle &sp, Cell &sys, double t, int ind, rng_t
             // Perform sintering update.
             if (m_sint_model.IsEnabled()) {
                 sp.Sinter(dt, sys, m_sint_model, rng, sp.getStatisticalWeight());
+                changed = true;
             }
 
 			//Melting point phase transformation
 			if (m_melt_model.IsEnabled()) {
 				sp.Melt(rng, sys);
+				changed = true;
 			}
         }
 
@@ -1488,6 +1626,8 @@ void Mechanism::UpdateParticle(Particle &sp, Cell &sys, double t, int ind, rng_t
         if (sp.IsValid())
             sp.UpdateCache();
     }
+
+    return changed;
 }
 
 void Mechanism::Mass_pah(Ensemble &m_ensemble) const
@@ -0,0 +1,186 @@
+/*!
+ * \file   swp_object_pool.cpp
+ *
+ *  Project:        sweepc (population balance solver)
+ *  Sourceforge:    http://sourceforge.net/projects/mopssuite
+ *
+ * \brief  Implementation of the pooled memory for particles and primaries
+ *
+ Licence:
+    This file is part of "sweepc".
+
+    sweepc is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+  Contact:
+    Prof Markus Kraft
+    Dept of Chemical Engineering
+    University of Cambridge
+    New Museums Site
+    Pembroke Street
+    Cambridge
+    CB2 3RA
+    UK
+
+    Email:       mk306@cam.ac.uk
+    Website:     http://como.cheng.cam.ac.uk
+ */
+
+#include "swp_object_pool.h"
+
+#include <new>
+#include <vector>
+#include <algorithm>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace Sweep;
+
+namespace
+{
+    //! Free block, the link is stored in the block itself
+    struct FreeBlock
+    {
+        FreeBlock *next;
+    };
+
+    //! Heads of the free lists of this thread, one per size class
+    FreeBlock *free_lists[ObjectPool::ClassCount];
+
+    //! Value of generation when the free lists of this thread were started
+    unsigned long list_generation;
+    #pragma omp threadprivate(free_lists, list_generation)
+
+    //! Chunks obtained from the system by all threads
+    std::vector<char*> chunks;
+
+    //! Number of blocks handed out and not yet released, over all threads
+    long live_blocks = 0;
+
+    //! Number of times the chunks have been returned to the system
+    unsigned long generation = 0;
+
+    //! Empty the free lists of this thread if they point into purged chunks
+    inline void checkGeneration()
+    {
+        if (list_generation != generation) {
+            std::fill(free_lists, free_lists + ObjectPool::ClassCount,
+                      static_cast<FreeBlock*>(NULL));
+            list_generation = generation;
+        }
+    }
+}
+
+/*!
+ * @param[in]   n       Number of bytes required
+ *
+ * @return      Pointer to a block aligned to Granularity bytes
+ *
+ * @exception   std::bad_alloc  Out of memory
+ */
+void *ObjectPool::Allocate(std::size_t n)
+{
+    if (n > MaxSize)
+        return ::operator new(n);
+
+    // Size class, zero byte requests get the smallest block
+    const std::size_t c = (n > 0) ? (n - 1) / Granularity : 0;
+    checkGeneration();
+    if (free_lists[c] == NULL)
+        refill(c);
+
+    FreeBlock *block = free_lists[c];
+    free_lists[c] = block->next;
+
+    #pragma omp atomic
+    ++live_blocks;
+
+    return block;
+}
+
+/*!
+ * @param[in]   p       Block to release, may be NULL
+ * @param[in]   n       Size that was passed to Allocate
+ */
+void ObjectPool::Release(void *p, std::size_t n)
+{
+    if (p == NULL)
+        return;
+
+    if (n > MaxSize) {
+        ::operator delete(p);
+        return;
+    }
+
+    const std::size_t c = (n > 0) ? (n - 1) / Granularity : 0;
+    checkGeneration();
+    FreeBlock *block = static_cast<FreeBlock*>(p);
+    block->next = free_lists[c];
+    free_lists[c] = block;
+
+    #pragma omp atomic
+    --live_blocks;
+}
+
+/*!
+ * The free lists of every thread point into the chunks, so they can only
+ * be released while a single thread is running.  Other threads find their
+ * lists out of date the next time they use the pool and start new ones.
+ *
+ * @return      True if the chunks were released, false if pooled objects
+ *              are still alive or the call was made in a parallel region
+ */
+bool ObjectPool::Purge()
+{
+#ifdef _OPENMP
+    if (omp_in_parallel())
+        return false;
+#endif
+    if (live_blocks != 0)
+        return false;
+
+    for (std::vector<char*>::const_iterator it = chunks.begin();
+         it != chunks.end(); ++it) {
+        ::operator delete(*it);
+    }
+    std::vector<char*>().swap(chunks);
+    ++generation;
+    return true;
+}
+
+/*!
+ * @param[in]   c       Size class whose free list is empty
+ *
+ * @exception   std::bad_alloc  Out of memory
+ */
+void ObjectPool::refill(std::size_t c)
+{
+    const std::size_t blocksize = (c + 1) * Granularity;
+    const std::size_t nblocks = ChunkSize / blocksize;
+    char *chunk = static_cast<char*>(::operator new(nblocks * blocksize));
+
+    #pragma omp critical(sweep_object_pool)
+    chunks.push_back(chunk);
+
+    // Link the blocks in address order, so that consecutive
+    // allocations are close together in memory.
+    for (std::size_t i = 0; i + 1 < nblocks; ++i) {
+        reinterpret_cast<FreeBlock*>(chunk + i * blocksize)->next =
+            reinterpret_cast<FreeBlock*>(chunk + (i + 1) * blocksize);
+    }
+    reinterpret_cast<FreeBlock*>(chunk + (nblocks - 1) * blocksize)->next = free_lists[c];
+    free_lists[c] = reinterpret_cast<FreeBlock*>(chunk);
+}
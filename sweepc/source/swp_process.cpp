@@ -443,6 +443,21 @@ double Process::chemRatePart(const EnvironmentInterface &gas) const
 void Process::adjustGas(Cell &sys, double wt, unsigned int n) const
 {
     if(!sys.FixedChem()) {
+        double n_NAvol = wt * (double)n / (NA * sys.SampleVolume());
+        Sprog::StoichMap::const_iterator i;
+
+        // Collect the changes if they are being deferred, as the gas
+        // phase may be shared with other threads.
+        if (sys.GasChangesDeferred()) {
+            Cell::GasChangeBuffer &buf = sys.GasChanges();
+            for (i=m_reac.begin(); i!=m_reac.end(); ++i)
+                buf.Concs[i->first] -= (double)(i->second) * n_NAvol;
+            for (i=m_prod.begin(); i!=m_prod.end(); ++i)
+                buf.Concs[i->first] += (double)(i->second) * n_NAvol;
+            buf.Changed = true;
+            return;
+        }
+
         // This method requires write access to the gas phase, which is not
         // standard in sweep.  This means it cannot use the generic gas
         // phase interface
@@ -458,8 +473,6 @@ void Process::adjustGas(Cell &sys, double wt, unsigned int n) const
         gas->GetConcs(newConcs);
 
         // Now adjust the concentrations
-        Sprog::StoichMap::const_iterator i;
-        double n_NAvol = wt * (double)n / (NA * sys.SampleVolume());
         for (i=m_reac.begin(); i!=m_reac.end(); ++i)
             newConcs[i->first] -= (double)(i->second) * n_NAvol;
         for (i=m_prod.begin(); i!=m_prod.end(); ++i)
@@ -539,9 +552,13 @@ void Process::adjustParticleTemperature(Cell &sys, double wt, unsigned int n, do
 		double P_R = gas->Pressure() / R;
 		double Hp = Hs[pindex];
 
-		// Get the existing concentrations
-		fvector newConcs;
-		gas->GetConcs(newConcs);
+		// Get the existing concentrations, or the buffer of changes if
+		// they are being deferred.
+		const bool deferred = sys.GasChangesDeferred();
+		fvector concs;
+		fvector &newConcs = deferred ? sys.GasChanges().Concs : concs;
+		if (!deferred)
+			gas->GetConcs(newConcs);
 
 		// Concentration change in system due to new particle(s)
 		double n_NAvol = wt * (double)n / 20;
@@ -576,6 +593,20 @@ void Process::adjustParticleTemperature(Cell &sys, double wt, unsigned int n, do
 		// ljx + Cprhop??)
 		deltaHr *= 1.0 / (Cgrhog + Cprhop);
  		newTg -= deltaHr;
+
+		if (deferred)
+		{
+			// Record the temperature change and the expansion term; the
+			// gas phase is updated once by Cell::ApplyGasChanges.
+			Cell::GasChangeBuffer &buf = sys.GasChanges();
+			if (constv)
+				newTg -= (R * oldTg * gdot / (Cgrhog + Cprhop));
+			else
+				buf.Expansion += (gdot / rhog);
+			buf.Temperature += (newTg - oldTg);
+			buf.Changed = true;
+			return;
+		}
 		
 		if (constv)
 		{
@@ -96,6 +96,15 @@ int Solver::Run(double &t, double tstop, Cell &sys, const Mechanism &mech,
     int err = 0;
     double tsplit, dtg, jrate, tflow(t);
     fvector rates(mech.TermCount(), 0.0);
+    SumTree tree;
+
+    // Number of inception terms, which come first in the rate vector.
+    unsigned int nicn = 0;
+    for (Processes::IcnPtrVector::const_iterator ii=mech.Inceptions().begin();
+         ii!=mech.Inceptions().end(); ++ii) {
+        nicn += (*ii)->TermCount();
+    }
+
     // Global maximum time step.
     dtg     = tstop - t;
     double tin = t; //store start time 
@@ -116,13 +125,35 @@ int Solver::Run(double &t, double tstop, Cell &sys, const Mechanism &mech,
         }
 	tin = t;
 
+        // The rate terms are only recalculated when their inputs may have
+        // changed.  Inception rates depend only on the gas phase and the
+        // sample volume, the other terms also on the particles.  The gas
+        // phase can only change between events if the particle processes
+        // feed back to it (FixedChem off), and the particles only change
+        // if the ensemble version does.  All terms are recalculated at the
+        // start of each split step, as LPDA has updated the particles.
+        bool all = true;
+        double vol = sys.SampleVolume();
+        unsigned long version = sys.Particles().Version();
+
         // Perform stochastic jump processes.
         while (t < tsplit) {
 
             // Sweep does not do transport
-            jrate = mech.CalcJumpRateTerms(t, sys, Geometry::LocalGeometry1d(), rates);
+            const bool icn = all || !sys.FixedChem() || (sys.SampleVolume() != vol);
+            if (icn || (sys.Particles().Version() != version)) {
+                mech.CalcJumpRateTerms(t, sys, Geometry::LocalGeometry1d(), rates, icn);
+
+                // Only the recalculated terms which have changed are
+                // updated in the rate tree.
+                tree.Assign(rates, icn ? 0 : nicn);
+                vol = sys.SampleVolume();
+                version = sys.Particles().Version();
+                all = false;
+            }
+
             timeStep(t, std::min(t + dtg / 3.0, tsplit), sys, Geometry::LocalGeometry1d(),
-                     mech, rates, jrate, rng);
+                     mech, tree, rng);
 
             // Do particle transport
             if (sys.OutflowCount() > 0 || sys.InflowCount() > 0)
@@ -225,6 +256,50 @@ void Solver::timeStep(double &t, double t_stop, Cell &sys, const Geometry::Local
     //std::cout << std::endl;
 }
 
+/*!
+ * As above, but the total jump rate is the sum held by the rate tree and the
+ * process is selected by descending the tree, in logarithmic rather than
+ * linear time in the number of rate terms.
+ *
+ *@param[in,out]    t           Current time, which will be updated
+ *@param[in]        t_stop      Time past which step may not go
+ *@param[in,out]    sys         System in which jump will take place
+ *@param[in]        geom        Specify size and neighbours of cell
+ *@param[in]        mech        Mechanism specifying the jump
+ *@param[in]        rates       Tree of computational jump rates, one for each jump process term
+ *@param[in,out]    rng         Random number generator
+ *
+ *@pre      t <= t_stop
+ *@post     t <= t_stop
+ */
+void Solver::timeStep(double &t, double t_stop, Cell &sys, const Geometry::LocalGeometry1d &geom,
+                      const Mechanism &mech, const SumTree &rates, rng_type &rng)
+{
+    double dt;
+    const double jrate = rates.Total();
+
+    // Calculate exponentially distributed time step size.
+    if (jrate > 0.0) {
+        boost::exponential_distribution<double> waitDistrib(jrate);
+        boost::variate_generator<Sweep::rng_type&, boost::exponential_distribution<double> > waitGenerator(rng, waitDistrib);
+        dt = waitGenerator();
+    } else {
+        // Avoid divide by zero.
+        dt = std::numeric_limits<double>::max();
+    }
+
+    // Truncate if step is too long or select a process
+    // to perform.
+    if (t+dt <= t_stop) {
+        boost::uniform_01<rng_type &> uniformGenerator(rng);
+        const int i = rates.Select(uniformGenerator());
+        mech.DoProcess(i, t+dt, sys, geom, rng);
+        t += dt;
+    } else {
+        t = t_stop;
+    }
+}
+
 // Selects a process using a DIV algorithm and the process rates
 // as weights.
 int Solver::chooseProcess(const fvector &rates, double (*rand_u01)())
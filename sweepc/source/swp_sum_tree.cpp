@@ -0,0 +1,153 @@
+/*!
+ * \file   swp_sum_tree.cpp
+ *
+ *  Project:        sweepc (population balance solver)
+ *  Sourceforge:    http://sourceforge.net/projects/mopssuite
+ *
+ * \brief  Implementation of the binary sum tree over a vector of weights
+ *
+ Licence:
+    This file is part of "sweepc".
+
+    sweepc is free software; you can redistribute it and/or
+    modify it under the terms of the GNU General Public License
+    as published by the Free Software Foundation; either version 2
+    of the License, or (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+  Contact:
+    Prof Markus Kraft
+    Dept of Chemical Engineering
+    University of Cambridge
+    New Museums Site
+    Pembroke Street
+    Cambridge
+    CB2 3RA
+    UK
+
+    Email:       mk306@cam.ac.uk
+    Website:     http://como.cheng.cam.ac.uk
+ */
+
+#include "swp_sum_tree.h"
+
+using namespace Sweep;
+
+//! Create an empty tree
+SumTree::SumTree()
+: m_size(0), m_leaves(0)
+{}
+
+/*!
+ * @param[in]   n       Number of weights
+ */
+void SumTree::Resize(unsigned int n)
+{
+    m_size = n;
+    m_leaves = 1;
+    while (m_leaves < m_size)
+        m_leaves *= 2;
+    m_sums.assign(2 * m_leaves, 0.0);
+}
+
+/*!
+ * The tree is rebuilt from all the weights if their number has changed.
+ * Otherwise only the weights from first onwards whose values differ from
+ * the stored ones are updated.
+ *
+ * @param[in]   weights     New weights
+ * @param[in]   first       Index of the first weight which may have changed
+ */
+void SumTree::Assign(const fvector &weights, unsigned int first)
+{
+    if (weights.size() != m_size) {
+        Resize(weights.size());
+        for (unsigned int i = 0; i != m_size; ++i)
+            m_sums[m_leaves + i] = weights[i];
+        Rebuild();
+        return;
+    }
+
+    for (unsigned int i = first; i < m_size; ++i) {
+        if (weights[i] != m_sums[m_leaves + i])
+            Update(i, weights[i]);
+    }
+}
+
+/*!
+ * @param[in]   i       Index of the weight
+ * @param[in]   w       New value of the weight
+ */
+void SumTree::Update(unsigned int i, double w)
+{
+    unsigned int k = m_leaves + i;
+    m_sums[k] = w;
+    for (k /= 2; k != 0; k /= 2)
+        m_sums[k] = m_sums[2 * k] + m_sums[2 * k + 1];
+}
+
+//! Recompute all inner nodes from the leaves
+void SumTree::Rebuild()
+{
+    if (m_leaves == 0)
+        return;
+
+    for (unsigned int k = m_leaves - 1; k > 0; --k)
+        m_sums[k] = m_sums[2 * k] + m_sums[2 * k + 1];
+}
+
+/*!
+ * @param[in]   r       Target cumulative sum, in [0, Total())
+ *
+ * @return      Index of the weight
+ *
+ * Rounding may carry the descent onto a trailing zero weight, so callers
+ * which need a non-zero weight should use Select.
+ */
+unsigned int SumTree::Find(double r) const
+{
+    unsigned int k = 1;
+    while (k < m_leaves) {
+        k *= 2;
+        if (r >= m_sums[k]) {
+            r -= m_sums[k];
+            ++k;
+        }
+    }
+
+    const unsigned int i = k - m_leaves;
+    return (i < m_size) ? i : m_size - 1;
+}
+
+/*!
+ * @param[in]   u       Uniform random number on [0, 1)
+ *
+ * @return      Index of the selected weight, or -1 if all weights are zero
+ */
+int SumTree::Select(double u) const
+{
+    if (Total() <= 0.0)
+        return -1;
+
+    // Round-off, or the target landing exactly on a partial sum, can find
+    // a zero weight.  Step back to the nearest non-zero weight, or forward
+    // if there is none before it.
+    const unsigned int i = Find(u * Total());
+    unsigned int j = i;
+    while ((j > 0) && (m_sums[m_leaves + j] <= 0.0))
+        --j;
+    if (m_sums[m_leaves + j] <= 0.0) {
+        j = i;
+        while ((j + 1 < m_size) && (m_sums[m_leaves + j] <= 0.0))
+            ++j;
+    }
+    return j;
+}